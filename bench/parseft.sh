@@ -0,0 +1,85 @@
+#!/bin/sh
+# parseft.sh -- Measure the worst-case latency of parsing date strings
+#
+# Copyright (C) 2025 Yoshinori Kawagita.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# Usage: parseft.sh DIR [NUMBER]
+#
+# Run the parseft command built into DIR for pathological strings, which
+# are long nests of comments, thousands of relative units, giant runs of
+# digits, and so on, doubling their length, and display the average
+# nanoseconds for parsing a string NUMBER times. The time must grow only
+# in proportion to the length because parsing is linear. And then, parse
+# complex strings of dates and times, which backtrack sub-parsers at the
+# same token, 100 times as NUMBER to compare their average nanoseconds
+# with the build memoizing results of sub-parsers.
+
+bindir=${1:-glibc}
+repeat=${2:-20}
+
+# Output a string of the specified pattern repeated N times, and the
+# trailing string.
+pattern () {
+  awk -v s="$1" -v n="$2" -v t="$3" 'BEGIN {
+    for (i = 0; i < n; i++)
+      printf "%s", s;
+    printf "%s", t;
+  }'
+}
+
+printf "%-22s %8s %12s\n" "STRING" "LENGTH" "NSEC"
+
+for n in 1000 2000 4000 8000 16000; do
+  for name in comment-nest comment-open rel-units digit-run fraction \
+              long-word spaces signs; do
+    case $name in
+    comment-nest)
+      s=`pattern "(" $n; pattern ")" $n " 1 day"` ;;
+    comment-open)
+      s=`pattern "(" $n` ;;
+    rel-units)
+      s=`pattern "1 day " $n` ;;
+    digit-run)
+      s=`pattern "0" $n "1 days"` ;;
+    fraction)
+      s=`pattern "0" $n " sec" | sed 's/^/1./'` ;;
+    long-word)
+      s=`pattern "a" $n` ;;
+    spaces)
+      s=`pattern " " $n "now"` ;;
+    signs)
+      s=`pattern "- " $n "1 day"` ;;
+    esac
+
+    nsec=`"$bindir/parseft" -n $repeat -- "$s"`
+    printf "%-22s %8d %12s\n" "$name" ${#s} "$nsec"
+  done
+done
+
+repeat_complex=`expr $repeat \* 100`
+
+for name in iso-datetime rfc-datetime ctime-datetime iso-date-rels \
+            times-zones; do
+  case $name in
+  iso-datetime)
+    s="2024-05-06T07:08:09.123456789+09:00" ;;
+  rfc-datetime)
+    s="Mon, 06 May 2024 07:08:09 +0000" ;;
+  ctime-datetime)
+    s="Tue Jan  1 00:00:00 UTC 2019" ;;
+  iso-date-rels)
+    s="2024-05-06 07:08 -3 hours +15 minutes 2 days ago next friday" ;;
+  times-zones)
+    s="10:20:30.5+09:00 11:22:33-0530 12:34:56.789 UTC 2024-01-01" ;;
+  esac
+
+  nsec=`"$bindir/parseft" -n $repeat_complex -- "$s"`
+  printf "%-22s %8d %12s\n" "$name" ${#s} "$nsec"
+done
+
+exit 0
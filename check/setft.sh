@@ -0,0 +1,50 @@
+#!/bin/sh
+# setft.sh -- Check file times set to symbolic links and directories
+#
+# Copyright (C) 2025 Yoshinori Kawagita.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# Usage: setft.sh DIR
+#
+# Create a file, a symbolic link to it and a directory in a temporary
+# directory. And then, run the setft command built into DIR with -h for
+# the link and the directory, and check that their modification times are
+# set, not rejected because they are not opened, and that the time of the
+# file referenced by the link is not changed.
+
+bindir=${1:-glibc}
+
+case $bindir in
+/*) ;;
+*) bindir=`pwd`/$bindir ;;
+esac
+
+workdir=`mktemp -d "${TMPDIR:-/tmp}/timeutils-setft.XXXXXX"` || exit 1
+trap 'rm -rf "$workdir"' 0 1 2 15
+
+cd "$workdir" || exit 1
+touch -m -d '2000-01-01 00:00:00 UTC' file \
+  && ln -s file link && mkdir dir || exit 1
+
+status=0
+
+for name in link dir; do
+  if TZ=UTC0 "$bindir/setft" -h $name 2001-02-03T04:05:06 0 0 0 0 0 0 0 \
+     && [ "`stat -c %Y $name`" = 981173106 ]; then
+    echo "setft -h $name: OK"
+  else
+    echo "setft -h $name: FAIL"
+    status=1
+  fi
+done
+
+if [ "`stat -c %Y file`" != 946684800 ]; then
+  echo "setft -h link: referenced file is changed" >&2
+  status=1
+fi
+
+exit $status
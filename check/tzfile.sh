@@ -0,0 +1,69 @@
+#!/bin/sh
+# tzfile.sh -- Check time zones loaded from slim TZif files
+#
+# Copyright (C) 2025 Yoshinori Kawagita.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# Usage: tzfile.sh DIR [STEP]
+#
+# Compile time zones whose last transition is before 1970 and after which
+# the rule in the footer is in effect, into slim and fat TZif files by zic
+# in a temporary directory. And then, run the localtime command built into
+# DIR with -Z for seconds every STEP from 1895 to 2105, and compare local
+# times converted in slim files, which are evaluated by the footer, with
+# those in fat files, which contain all transitions until 2037.
+
+bindir=${1:-glibc}
+step=${2:-3456007}
+
+case $bindir in
+/*) ;;
+*) bindir=`pwd`/$bindir ;;
+esac
+
+workdir=`mktemp -d "${TMPDIR:-/tmp}/timeutils-tzfile.XXXXXX"` || exit 1
+trap 'rm -rf "$workdir"' 0 1 2 15
+
+cat > "$workdir/zones" <<'EOF'
+Rule	N	1900	max	-	Apr	Sun>=1	2:00	1:00	D
+Rule	N	1900	max	-	Oct	lastSun	2:00	0	S
+Zone	Check/North	-4:56:02 -	LMT	1900 Jan  1 12:00
+			-5:00	N	E%sT
+Rule	S	1950	max	-	Oct	Sun>=1	2:00	1:00	-
+Rule	S	1950	max	-	Apr	Sun>=1	3:00	0	-
+Zone	Check/South	10:04:52 -	LMT	1949 Jun  1
+			10:00	S	AE%sT
+Zone	Check/Epoch	-5:00	-	EST	1969 Dec 31 23:00
+			-5:00	N	E%sT
+EOF
+
+zic -b slim -d "$workdir/slim" "$workdir/zones" \
+  && zic -b fat -d "$workdir/fat" "$workdir/zones" || exit 1
+
+status=0
+
+for zone in North South Epoch; do
+  seconds=-2366755200
+  failed=0
+  while [ $seconds -lt 4291747200 ]; do
+    slim=`"$bindir/localtime" -a -Z "$workdir/slim/Check/$zone" -- $seconds`
+    fat=`"$bindir/localtime" -a -Z "$workdir/fat/Check/$zone" -- $seconds`
+    if [ "$slim" != "$fat" ]; then
+      echo "Check/$zone $seconds: $slim, expected $fat" >&2
+      failed=1
+    fi
+    seconds=`expr $seconds + $step`
+  done
+  if [ $failed -ne 0 ]; then
+    echo "Check/$zone: FAIL"
+    status=1
+  else
+    echo "Check/$zone: OK"
+  fi
+done
+
+exit $status
@@ -20,71 +20,154 @@
 #ifndef USE_TM_GLIBC
 # include <windows.h>
 #endif
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 
 #include "adjusttm.h"
-#include "intoverflow.h"
 
-/* Bring the tm_mday member in *TM into the range of correct day in a month
-   and adjust other parameters of date by changed days. Calculate and set
-   the week day into the tm_wday member when it contains the negative value.
-   If adjustment is performed, return true and overwrite *TM by those values,
-   otherwise, return false and never change.  */
+/* The number of days from 0000-03-01 to 1970-01-01, counted in the cycle
+   of 400 years which starts after a leap day  */
+#define MARCH0_EPOCH_DAYS 719468
 
-bool
-adjustday (struct dtm *tm)
-{
-  int year;
-  int year0;
-  int mon = tm->tm_mon;
-  int days;  /* Days from Jan 0th to the correct date */
-  int ydays; /* Days from Jan 0th to in the last month in a year */
-  bool has_noleapday;
+/* The number of days from 1 Mar to 31 Dec in a year  */
+#define MARCH_TO_DECEMBER_DAYS 306
 
-  /* Bring the number of month into the range of 0 to 11 and increase
-     or decrease the number of year by its carried value. */
-  if (INT_ADD_WRAPV (tm->tm_year, TM_YEAR_BASE, &year)
-      || ! carrytm (&year, &mon, 12))
-    return false;
+#ifdef USE_EPOCHDAY_TABLE
+/* The first and last year whose days are looked up in tables  */
+# define EPOCHDAY_FIRST_YEAR UNIXEPOCH_YEAR
+# define EPOCHDAY_LAST_YEAR  2100
 
-  /* Add days from January to the last month in year to the number of days,
-     and set the number of month to 0 temporarily. */
-  days = YEAR_DAYS (year, mon);
-  if (INT_ADD_WRAPV (days, tm->tm_mday, &days))
-    return false;
+/* The number of years looked up in tables  */
+# define EPOCHDAY_YEARS (EPOCHDAY_LAST_YEAR - EPOCHDAY_FIRST_YEAR + 1)
 
-  /* Increase or decrease the number of days in 400 years. */
-  if (! adjusttm (&year, 400, &days, DAYS_IN_400YEARS))
-    return false;
+/* Expand the value of F for 10 years since YEAR into elements of a table
+   by the preprocessor  */
+# define EPOCHDAY_10YEARS(f,year) \
+  f (year), f ((year) + 1), f ((year) + 2), f ((year) + 3), f ((year) + 4), \
+  f ((year) + 5), f ((year) + 6), f ((year) + 7), f ((year) + 8), \
+  f ((year) + 9)
 
-  /* Convert the number of days into years within 400 years. */
-  year0 = year;
-  if (! adjusttm (&year, 1, &days, DAYS_IN_YEAR))
-    return false;
-  else if (year ^ year0)
-    {
-      int year1 = year;
+# define YEAR_START_DAYS(year) EPOCH_DAYS (year, 0)
+# define YEAR_START_WDAY(year) \
+  WEEKDAY_FROM (UNIXEPOCH_WEEKDAY, EPOCH_DAYS (year, 0))
 
-      if (year1 > year0)
-        year1--;
-      else
-        year0--;
+/* Days elapsed from 1970-01-01 to January 1 in each year, and the next
+   year after the last year  */
+static const int32_t year_start_days[EPOCHDAY_YEARS + 1] =
+{
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 1970),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 1980),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 1990),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2000),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2010),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2020),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2030),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2040),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2050),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2060),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2070),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2080),
+  EPOCHDAY_10YEARS (YEAR_START_DAYS, 2090),
+  YEAR_START_DAYS (2100), YEAR_START_DAYS (2101)
+};
+
+/* Week days of January 1 in each year  */
+static const unsigned char year_start_wdays[EPOCHDAY_YEARS] =
+{
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 1970),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 1980),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 1990),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2000),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2010),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2020),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2030),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2040),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2050),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2060),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2070),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2080),
+  EPOCHDAY_10YEARS (YEAR_START_WDAY, 2090),
+  YEAR_START_WDAY (2100)
+};
+
+/* Days from January 1 to the first day of each month and the next year,
+   indexed by whether a leap day is not included in a year  */
+static const short month_start_days[2][13] =
+{
+  { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, DAYS_IN_LEAPYEAR },
+  { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, DAYS_IN_YEAR }
+};
+#endif
 
-      /* Subtract the number of leap days from days, ignored for the conversion
-         to years because of the maximum 97 days less than a year. */
-      if (INT_SUBTRACT_WRAPV (days, leapdays (year0, year1), &days))
-        return false;
-    }
+/* Bring the tm_mday and tm_mon member in *TM into the range of correct
+   day and month and adjust the tm_year member by changed days. Set the
+   day in a year and the week day into the tm_yday and tm_wday member.
+   Return the number of days elapsed from 1970-01-01 to the date.  */
 
-  /* Decrement the number of year to subtract the value from days in the last
-     year if the number of days is less than or equal to 0. */
-  if (days <= 0)
+int64_t
+adjustday64 (struct dtm64 *tm)
+{
+  int64_t year = tm->tm_year + TM_YEAR_BASE + FLOOR_DIV (tm->tm_mon, 12);
+  int mon = tm->tm_mon - FLOOR_DIV (tm->tm_mon, 12) * 12;
+  int64_t days;
+
+#ifdef USE_EPOCHDAY_TABLE
+  /* Look up days for the year and month in tables if in range. */
+  if (year >= EPOCHDAY_FIRST_YEAR && year <= EPOCHDAY_LAST_YEAR)
+    days = year_start_days[year - EPOCHDAY_FIRST_YEAR]
+           + month_start_days[HAS_NOLEAPDAY (year) ? 1 : 0][mon]
+           + tm->tm_mday - 1;
+  else
+#endif
+    days = EPOCH_DAYS (year, YEAR_DAYS (year, mon)) + tm->tm_mday - 1;
+
+#ifdef USE_EPOCHDAY_TABLE
+  /* Look up the year and month for days in tables if in range, for which
+     the year and month is estimated by dividing days by 365 and 32 and
+     may be only one greater and less than the correct value. */
+  if (days >= 0 && days < year_start_days[EPOCHDAY_YEARS])
     {
-      if (INT_SUBTRACT_WRAPV (year, 1, &year))
-        return false;
-      days += YEAR_ALL_DAYS (year);
+      int index = days / DAYS_IN_YEAR;
+      const short *mstart_days;
+
+      if (days < year_start_days[index])
+        index--;
+
+      tm->tm_yday = days - year_start_days[index];
+      year = EPOCHDAY_FIRST_YEAR + index;
+      mstart_days = month_start_days[HAS_NOLEAPDAY (year) ? 1 : 0];
+      mon = tm->tm_yday / 32;
+      if (tm->tm_yday >= mstart_days[mon + 1])
+        mon++;
+
+      tm->tm_year = year - TM_YEAR_BASE;
+      tm->tm_mon = mon;
+      tm->tm_mday = tm->tm_yday - mstart_days[mon] + 1;
+      tm->tm_wday = (year_start_wdays[index] + tm->tm_yday) % 7;
+
+      return days;
     }
+#endif
+
+  /* Convert the number of days into years and days in 400 years starting
+     on 1 Mar, for which a leap day is the last day in each 4 years. */
+  int64_t mdays = days + MARCH0_EPOCH_DAYS;
+  int64_t cycles = FLOOR_DIV (mdays, DAYS_IN_400YEARS);
+  int cdays = mdays - cycles * DAYS_IN_400YEARS;
+  int cyears = (cdays - cdays / (DAYS_IN_4YEARS - 1)
+                + cdays / DAYS_IN_100YEARS
+                - cdays / (DAYS_IN_400YEARS - 1)) / DAYS_IN_YEAR;
+  int ydays; /* Days from Jan 0th to in the last month in a year */
+  bool has_noleapday;
+
+  /* Increment the year for January and February in the next year. */
+  year = cycles * 400 + cyears;
+  if (cdays - (cyears * DAYS_IN_YEAR + cyears / 4 - cyears / 100)
+      >= MARCH_TO_DECEMBER_DAYS)
+    year++;
+
+  tm->tm_yday = days - EPOCH_DAYS (year, 0);
 
   /* Cut the value over days of each month in a year from the number of day,
      and set the number of month to the correct value. */
@@ -95,18 +178,62 @@ adjustday (struct dtm *tm)
       mon--;
       ydays = yeardays (has_noleapday, mon);
     }
-  while (days <= ydays);
-
-  if (INT_SUBTRACT_WRAPV (year, TM_YEAR_BASE, &tm->tm_year))
-    return -1;
+  while (tm->tm_yday < ydays);
 
+  tm->tm_year = year - TM_YEAR_BASE;
   tm->tm_mon = mon;
-  tm->tm_mday = days - ydays;
-  tm->tm_yday = days - 1;
+  tm->tm_mday = tm->tm_yday - ydays + 1;
+  tm->tm_wday = WEEKDAY_FROM (UNIXEPOCH_WEEKDAY, days);
+
+  return days;
+}
+
+/* Adjust members in *TM and *DAYS, which are the date and days elapsed
+   from 1970-01-01 to it as set by adjustday64 function, to the day for
+   the specified seconds since 1970-01-01 00:00. Return seconds elapsed
+   since the start of the day.  */
+
+int
+adjustdaysec (struct dtm64 *tm, int64_t *days, int64_t seconds)
+{
+  int64_t sec_days = FLOOR_DIV (seconds, SECONDS_IN_DAY);
+
+  if (sec_days != *days)
+    {
+      tm->tm_mday += sec_days - *days;
+      *days = adjustday64 (tm);
+    }
+
+  return seconds - sec_days * SECONDS_IN_DAY;
+}
+
+/* Bring the tm_mday member in *TM into the range of correct day in a month
+   and adjust other parameters of date by changed days. Calculate and set
+   the week day into the tm_wday member when it contains the negative value.
+   If adjustment is performed, return true and overwrite *TM by those values,
+   otherwise, return false and never change.  */
+
+bool
+adjustday (struct dtm *tm)
+{
+  struct dtm64 date = { .tm_mday = tm->tm_mday, .tm_mon = tm->tm_mon,
+                        .tm_year = tm->tm_year };
+
+  adjustday64 (&date);
+
+  /* Check whether the year and its value since TM_YEAR_BASE are in the
+     range of int at once. */
+  if (date.tm_year < INT_MIN || date.tm_year > INT_MAX - TM_YEAR_BASE)
+    return false;
+
+  tm->tm_year = date.tm_year;
+  tm->tm_mon = date.tm_mon;
+  tm->tm_mday = date.tm_mday;
+  tm->tm_yday = date.tm_yday;
 
   /* Calculate the week day if the tm_wday member is a negative value. */
   if (tm->tm_wday < 0)
-    tm->tm_wday = weekday (year, tm->tm_yday);
+    tm->tm_wday = date.tm_wday;
 
   return true;
 }
@@ -17,7 +17,11 @@
 
 #include <stdbool.h>
 
-#include "intoverflow.h"
+#include "adjusttm.h"
+
+/* Define the functions for the ABI instead of the macros  */
+#undef adjusttm
+#undef carrytm
 
 /* Decrease or increase PARAM2 toward zero by the multiple of BASE as many as
    possible and increase or decrease PARAM1 by its multiple of UNIT if PARAM2
@@ -27,22 +31,7 @@
 bool
 adjusttm (int *param1, int unit, int *param2, int base)
 {
-  if (base)
-    {
-      int delta = *param2 / base;
-
-      if (delta)
-        {
-          if (INT_ADD_WRAPV (*param1, delta * unit, param1))
-            return false;
-
-          *param2 -= delta * base;
-        }
-
-      return true;
-    }
-
-  return false;
+  return adjusttm_inline (param1, unit, param2, base);
 }
 
 /* Bring LOWPARAM into the range of 0 to BASE - 1 and increase or decrease
@@ -52,21 +41,5 @@ adjusttm (int *param1, int unit, int *param2, int base)
 bool
 carrytm (int *highparam, int *lowparam, int base)
 {
-  if (base)
-    {
-      int delta = *lowparam >= 0
-                  ? *lowparam / base : (*lowparam + 1) / base - 1;
-
-      if (delta)
-        {
-          if (INT_ADD_WRAPV (*highparam, delta, highparam))
-            return false;
-
-          *lowparam -= delta * base;
-        }
-
-      return true;
-    }
-
-  return false;
+  return carrytm_inline (highparam, lowparam, base);
 }
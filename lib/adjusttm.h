@@ -16,6 +16,14 @@
    along with this program; if not, write to the Free Software Foundation,
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
 
+#ifndef ADJUSTTM_H_
+# define ADJUSTTM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "intoverflow.h"
+
 /* The year of Unix epoch  */
 
 #define UNIXEPOCH_YEAR 1970
@@ -58,6 +66,11 @@ int yeardays (bool has_noleapday, int months);
 
 int leapdays (int from_year, int to_year);
 
+/* Calculate the number of leap days included in a duration between
+   the specified two years in 64 bits as with leapdays function.  */
+
+int64_t leapdays64 (int64_t from_year, int64_t to_year);
+
 /* Return the week day elapsed from the specified week day  */
 
 #define WEEKDAY_FROM(wday,yday) (((wday) + (int)((yday) % 7) + 7) % 7)
@@ -66,6 +79,23 @@ int leapdays (int from_year, int to_year);
 
 int weekday (int year, int yday);
 
+/* Return the quotient of A divided by B, rounded toward -Infinity  */
+
+#define FLOOR_DIV(a,b) ((a) / (b) - ((a) % (b) < 0))
+
+/* The number of days from 0001-01-01 to 1970-01-01  */
+
+#define UNIXEPOCH_DAYS 719162
+
+/* Return the number of days elapsed from 1970-01-01 to the specified day
+   since January 1 in YEAR, calculated by leap days in preceding years  */
+
+#define EPOCH_DAYS(year,yday) \
+  (((intmax_t) (year) - 1) * DAYS_IN_YEAR \
+   + FLOOR_DIV ((intmax_t) (year) - 1, 4) \
+   - FLOOR_DIV ((intmax_t) (year) - 1, 100) \
+   + FLOOR_DIV ((intmax_t) (year) - 1, 400) - UNIXEPOCH_DAYS + (yday))
+
 /* Seconds in a day  */
 
 #define SECONDS_IN_DAY 86400
@@ -98,6 +128,32 @@ struct dtm
 
 bool adjustday (struct dtm *tm);
 
+/* Parameters of date in 64 bits, which never overflow for the range
+   of FILETIME and time_t  */
+
+struct dtm64
+{
+  int64_t tm_mday;
+  int64_t tm_mon;
+  int64_t tm_year;
+  int tm_yday;
+  int tm_wday;
+};
+
+/* Bring the tm_mday and tm_mon member in *TM into the range of correct
+   day and month and adjust the tm_year member by changed days. Set the
+   day in a year and the week day into the tm_yday and tm_wday member.
+   Return the number of days elapsed from 1970-01-01 to the date.  */
+
+int64_t adjustday64 (struct dtm64 *tm);
+
+/* Adjust members in *TM and *DAYS, which are the date and days elapsed
+   from 1970-01-01 to it as set by adjustday64 function, to the day for
+   the specified seconds since 1970-01-01 00:00. Return seconds elapsed
+   since the start of the day.  */
+
+int adjustdaysec (struct dtm64 *tm, int64_t *days, int64_t seconds);
+
 /* Decrease or increase PARAM2 toward zero by the multiple of BASE as many as
    possible and increase or decrease PARAM1 by its multiple of UNIT if PARAM2
    is positive or negative. Return true if not overflow or divided by zero,
@@ -110,3 +166,85 @@ bool adjusttm (int *param1, int unit, int *param2, int base);
    true if not overflow or divided by zero, otherwise, false.  */
 
 bool carrytm (int *highparam, int *lowparam, int base);
+
+/* Inline versions of the above functions, which are called instead of
+   those if USE_TM_INLINE is defined  */
+
+static inline int
+yeardays_inline (bool has_noleapday, int months)
+{
+  static const int ydays[] =
+  {
+    0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, DAYS_IN_YEAR
+  };
+
+  if (months >= 0 && months <= 12)
+    {
+      if (has_noleapday || months < 2)
+        return ydays[months];
+
+      return ydays[months] + 1;
+    }
+
+  return -1;
+}
+
+static inline bool
+adjusttm_inline (int *param1, int unit, int *param2, int base)
+{
+  if (base)
+    {
+      int delta = *param2 / base;
+
+      if (delta)
+        {
+          if (int_add_overflow_inline (*param1, delta * unit, param1))
+            return false;
+
+          *param2 -= delta * base;
+        }
+
+      return true;
+    }
+
+  return false;
+}
+
+static inline bool
+carrytm_inline (int *highparam, int *lowparam, int base)
+{
+  if (base)
+    {
+      int delta = *lowparam >= 0
+                  ? *lowparam / base : (*lowparam + 1) / base - 1;
+
+      if (delta)
+        {
+          if (int_add_overflow_inline (*highparam, delta, highparam))
+            return false;
+
+          *lowparam -= delta * base;
+        }
+
+      return true;
+    }
+
+  return false;
+}
+
+static inline int
+weekday_inline (int year, int yday)
+{
+  return WEEKDAY_FROM (UNIXEPOCH_WEEKDAY, EPOCH_DAYS (year, yday));
+}
+
+#ifdef USE_TM_INLINE
+# define yeardays(has_noleapday,months) \
+           yeardays_inline (has_noleapday, months)
+# define weekday(year,yday) weekday_inline (year, yday)
+# define adjusttm(param1,unit,param2,base) \
+           adjusttm_inline (param1, unit, param2, base)
+# define carrytm(highparam,lowparam,base) \
+           carrytm_inline (highparam, lowparam, base)
+#endif
+#endif
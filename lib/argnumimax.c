@@ -22,6 +22,7 @@
 
 #include "argnum.h"
 #include "imaxoverflow.h"
+#include "swardigits.h"
 
 #define ISDIGIT(c)  (c >= '0' && c <= '9')
 
@@ -85,10 +86,26 @@ argnumimaxp (const char *arg, struct numimax_prop *num_prop,
   if (! ISDIGIT (*p))
     return 0;
 
-  intmax_t value = sign < 0 ? '0' - *p : *p - '0';
-  p++;
+  /* Skip leading zeros and count the rest of digits at first so that
+     those are converted by 8 without overflow unless more than the number
+     of digits in uint64_t. */
+  while (*p == '0' && ISDIGIT (p[1]))
+    p++;
 
-  /* Convert leading digits of the argument into an intmax_t value. */
+  int digit_num = 0;
+  do
+    digit_num++;
+  while (digit_num < SWAR_DIGITS_MAX && ISDIGIT (p[digit_num]));
+
+  uint64_t abs_value = swarndigits (p, digit_num);
+  if (abs_value > (sign < 0 ? - (uintmax_t) INTMAX_MIN : INTMAX_MAX))
+    return -1;
+
+  intmax_t value = sign < 0 && abs_value > 0
+                   ? - (intmax_t) (abs_value - 1) - 1 : (intmax_t) abs_value;
+  p += digit_num;
+
+  /* Convert excess digits of the argument into an intmax_t value. */
   while (ISDIGIT (*p))
     {
       if (IMAX_MULTIPLY_WRAPV (value, 10, &value)
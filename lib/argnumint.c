@@ -24,9 +24,19 @@
 #include "argnum.h"
 #include "imaxoverflow.h"
 #include "intoverflow.h"
+#include "swardigits.h"
 
 #define ISDIGIT(c)  (c >= '0' && c <= '9')
 
+/* The maximum number of fractional digits whose precision never overflows
+   int value  */
+#define FRAC_DIGITS_MAX 9
+
+/* Powers of 10 for the precision of fractional part  */
+static const int pow10s[FRAC_DIGITS_MAX + 1] =
+  { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000 };
+
 /* Parse the leading part of the specified argument as an integer number
    and set its value into *NUM_VAL, storing the pointer to a following
    character into *ENDPTR. Return 1 or 0 if a value is set or not,
@@ -88,31 +98,56 @@ argnumintp (const char *arg, struct numint_prop *num_prop,
   if (! ISDIGIT (*p))
     return 0;
 
+  /* Count leading digits at first so that those are converted by 8 and
+     overflow is checked only if possible by the number of digits. */
+  const char *digits = p;
+  int digit_num = 0;
+  do
+    digit_num++;
+  while (ISDIGIT (p[digit_num]));
+
   int frac_digits = num_prop->frac_digits;
-  int value = sign < 0 && frac_digits <= 0 ? '0' - *p : *p - '0';
-  p++;
+  int value;
 
   if (frac_digits > 0)
     {
-      bool digit_parsed = true;
-      int precision = 10;
+      int precision;
 
-      /* Accumulate the value of fractional part to the precision. */
-      while (--frac_digits > 0)
+      if (frac_digits <= FRAC_DIGITS_MAX)
         {
-          if ((sign < 0 && INT_MULTIPLY_WRAPV (precision, 10, &precision))
-              || INT_MULTIPLY_WRAPV (value, 10, &value))
-            return -1;
-          else if (digit_parsed)
+          /* Convert digits to the precision and pad it with zeros. */
+          int frac_num = digit_num < frac_digits ? digit_num : frac_digits;
+          precision = pow10s[frac_digits];
+          value = (int) swarndigits (p, frac_num)
+                  * pow10s[frac_digits - frac_num];
+          p += frac_num;
+        }
+      else
+        {
+          bool digit_parsed = true;
+
+          value = *p - '0';
+          precision = 10;
+          p++;
+
+          /* Accumulate the value of fractional part to the precision. */
+          while (--frac_digits > 0)
             {
-              if (ISDIGIT (*p))
+              if ((sign < 0
+                   && INT_MULTIPLY_WRAPV (precision, 10, &precision))
+                  || INT_MULTIPLY_WRAPV (value, 10, &value))
+                return -1;
+              else if (digit_parsed)
                 {
-                  if (INT_ADD_WRAPV (value, *p - '0', &value))
-                    return -1;
-                  p++;
+                  if (ISDIGIT (*p))
+                    {
+                      if (INT_ADD_WRAPV (value, *p - '0', &value))
+                        return -1;
+                      p++;
+                    }
+                  else
+                    digit_parsed = false;
                 }
-              else
-                digit_parsed = false;
             }
         }
 
@@ -144,20 +179,27 @@ argnumintp (const char *arg, struct numint_prop *num_prop,
         value = - value;
 
       /* Skip the rest of digits if over the precision. */
-      while (ISDIGIT (*p))
-        p++;
+      p = digits + digit_num;
     }
   else  /* frac_digits <= 0 */
     {
-      /* Convert leading digits of the argument into an integer value. */
-      while (ISDIGIT (*p))
+      /* Skip leading zeros, and convert the rest of digits without
+         overflow unless more than the number of digits in INT_MAX. */
+      while (digit_num > 1 && *p == '0')
         {
-          if (INT_MULTIPLY_WRAPV (value, 10, &value)
-              || INT_ADD_WRAPV (
-                   value, sign < 0 ? '0' - *p : *p - '0', &value))
-            return -1;
+          digit_num--;
           p++;
         }
+
+      if (digit_num > SWAR_DIGITS_MAX)
+        return -1;
+
+      uint64_t abs_value = swarndigits (p, digit_num);
+      if (abs_value > (sign < 0 ? - (uint64_t) INT_MIN : INT_MAX))
+        return -1;
+
+      value = sign < 0 ? (int) - (intmax_t) abs_value : (int) abs_value;
+      p += digit_num;
     }
 
   if (value < num_prop->min_value || value > num_prop->max_value
@@ -23,9 +23,146 @@
 #include "argnum.h"
 #include "cmdtmio.h"
 #include "ftsec.h"
+#include "swardigits.h"
 
 extern const char *arg_endptr;
 
+#define ISDIGIT(c)  (c >= '0' && c <= '9')
+
+/* The length of "YYYY-MM-DDThh:mm:ss" in the fixed layout  */
+#define ISO8601_FIXED_LEN 19
+
+/* The mask of digits in "YYYY-MM-" and "DDThh:mm"  */
+#define ISO8601_DATE_DIGITS 0x00ffff00ffffffffULL
+#define ISO8601_TIME_DIGITS 0xffff00ffff00ffffULL
+
+/* The value and mask of separators in "YYYY-MM-" and "DDThh:mm"  */
+#define ISO8601_DATE_SEPS   0x2d00002d00000000ULL
+#define ISO8601_TIME_SEPS   0x00003a0000540000ULL
+
+/* Parse the specified argument as "YYYY-MM-DDThh:mm:ss[.nnnnnnnnn]" and
+   "Z", "+hhmm", or "-hhmm" in the fixed layout, which is the most usual,
+   and set those values into members included in *TM_PTRS as with
+   argtmiso8601. Return the number of set values, otherwise, 0 if not the
+   fixed layout, which must be parsed by the general way.  */
+static int
+argtmiso8601_fixed (const char *arg, struct tm_ptrs *tm_ptrs, char **endptr)
+{
+  const char *p = arg;
+  int set_num = 6;
+  int ns = -1;
+  long int utcoff = 0;
+  bool utcoff_set = false;
+  int len;
+
+  if (! tm_ptrs->dates || ! tm_ptrs->times)
+    return 0;
+
+  /* Check the length before reading characters at once. */
+  for (len = 0; len < ISO8601_FIXED_LEN; len++)
+    {
+      if (p[len] == '\0')
+        return 0;
+    }
+
+  uint64_t date_word = swarload (p);
+  uint64_t time_word = swarload (p + 8);
+
+  if (! swardigits (date_word, ISO8601_DATE_DIGITS)
+      || (date_word & ~ISO8601_DATE_DIGITS) != ISO8601_DATE_SEPS
+      || ! swardigits (time_word, ISO8601_TIME_DIGITS)
+      || (time_word & ~ISO8601_TIME_DIGITS) != ISO8601_TIME_SEPS
+      || p[16] != ':' || ! ISDIGIT (p[17]) || ! ISDIGIT (p[18]))
+    return 0;
+
+  p += ISO8601_FIXED_LEN;
+
+  /* Input the nanoseconds less than a second. */
+  if (*p == '.' || *p == ',')
+    {
+      const char *digits = ++p;
+      int digit_num;
+
+      if (! tm_ptrs->ns)
+        return 0;
+
+      while (ISDIGIT (*p))
+        p++;
+
+      digit_num = p - digits;
+      if (digit_num == 0)
+        return 0;
+
+      /* Convert 8 digits at once if given, and the rest of digits to the
+         precision one by one, filling by zero. */
+      if (digit_num >= 8 && FT_NSEC_DIGITS >= 8)
+        {
+          int i;
+
+          ns = swar8digits (swarload (digits));
+          for (i = 8; i < FT_NSEC_DIGITS; i++)
+            ns = ns * 10 + (i < digit_num ? digits[i] - '0' : 0);
+        }
+      else
+        {
+          int i;
+
+          ns = 0;
+          for (i = 0; i < FT_NSEC_DIGITS; i++)
+            ns = ns * 10 + (i < digit_num ? digits[i] - '0' : 0);
+        }
+
+      set_num++;
+    }
+
+  /* Input "Z", "+hhmm", or "-hhmm" followed by no character. */
+  if (*p != '\0')
+    {
+      if (! tm_ptrs->utcoff)
+        return 0;
+      else if (*p == 'Z' && p[1] == '\0')
+        utcoff_set = true;
+      else if ((*p == '+' || *p == '-')
+               && ISDIGIT (p[1]) && ISDIGIT (p[2]) && ISDIGIT (p[3])
+               && ISDIGIT (p[4]) && p[5] == '\0')
+        {
+          int hhmm_val = (p[1] - '0') * 1000 + (p[2] - '0') * 100
+                         + (p[3] - '0') * 10 + (p[4] - '0');
+          if (hhmm_val > 2400)
+            return 0;
+
+          utcoff = ((hhmm_val / 100) * 60 + hhmm_val % 100) * 60;
+          if (*p == '-')
+            utcoff = - utcoff;
+          utcoff_set = true;
+        }
+      else
+        return 0;
+
+      set_num++;
+    }
+
+  *tm_ptrs->dates[0] = SWAR_2DIGITS (date_word, 0) * 100
+                       + SWAR_2DIGITS (date_word, 2);
+  *tm_ptrs->dates[1] = SWAR_2DIGITS (date_word, 5);
+  *tm_ptrs->dates[2] = SWAR_2DIGITS (time_word, 0);
+  *tm_ptrs->times[0] = SWAR_2DIGITS (time_word, 3);
+  *tm_ptrs->times[1] = SWAR_2DIGITS (time_word, 6);
+  *tm_ptrs->times[2] = (arg[17] - '0') * 10 + (arg[18] - '0');
+  if (ns >= 0)
+    *tm_ptrs->ns = ns;
+
+  if (utcoff_set)
+    {
+      *tm_ptrs->utcoff = utcoff;
+      p = arg_endptr;
+    }
+
+  *endptr = (char *)p;
+
+  return set_num;
+}
+
 /* Parse the leading part of the specified argument as ISO 8601 format
    and set those values into members included in *TM_PTRS, storing
    the pointer to a following character into *ENDPTR. The date, time,
@@ -52,6 +189,11 @@ argtmiso8601 (const char *arg, struct tm_ptrs *tm_ptrs, char **endptr)
   int times[3];
   int ns = -1;
 
+  /* Parse the argument fastly if in the fixed layout. */
+  set_num = argtmiso8601_fixed (arg, tm_ptrs, endptr);
+  if (set_num > 0)
+    return set_num;
+
   /* Input the year, month, and day. */
   if (tm_ptrs->dates && *p != 'T' && *p != 'Z')
     {
@@ -24,3 +24,21 @@
 /* Set the macro to not define _USE_32BIT_TIME_T in _mingw.h  */
 # define __MINGW_USE_VC2005_COMPAT
 #endif
+
+/* Expand small functions of date and overflow check into static inline
+   functions in headers unless NO_TM_INLINE is defined  */
+#ifndef NO_TM_INLINE
+# define USE_TM_INLINE
+#endif
+
+/* Look up days since 1970-01-01 for years from 1970 to 2100 in tables
+   generated at compile time unless NO_EPOCHDAY_TABLE is defined  */
+#ifndef NO_EPOCHDAY_TABLE
+# define USE_EPOCHDAY_TABLE
+#endif
+
+/* Memoize results of sub-parsers in parseft for each token by which their
+   parsing is started if PARSEFT_MEMO is defined  */
+#ifdef PARSEFT_MEMO
+# define USE_PARSEFT_MEMO
+#endif
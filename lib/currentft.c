@@ -26,24 +26,79 @@
 #include <stdint.h>
 
 #include "ft.h"
+#include "timeutils.h"
 
-/* Get the current time on system clock as file time in NTFS. Set its value
-   into *FT and return true if successfull, otherwise, return false.  */
+/* Get the current time on the specified clock as file time in NTFS. Set its
+   value into *FT and return true if successfull, otherwise, return false.
+   FT_CLOCK_FROZEN is the same as FT_CLOCK_PRECISE because the captured time
+   is kept by the context passed to currentftctx.  */
 
 bool
-currentft (FT *ft)
+currentftclock (FT *ft, int ft_clock)
 {
 #ifdef USE_TM_GLIBC
-  if (clock_gettime (CLOCK_REALTIME, ft) != 0)
+  clockid_t clock_id = CLOCK_REALTIME;
+# ifdef CLOCK_REALTIME_COARSE
+  if (ft_clock == FT_CLOCK_COARSE)
+    clock_id = CLOCK_REALTIME_COARSE;
+# endif
+
+  if (clock_gettime (clock_id, ft) != 0)
     return false;
 
 #else
+# if _WIN32_WINNT >= 0x0602
+  if (ft_clock == FT_CLOCK_PRECISE)
+    GetSystemTimePreciseAsFileTime (ft);
+  else
+# endif
   GetSystemTimeAsFileTime (ft);
 #endif
 
   return true;
 }
 
+/* Get the current time on system clock as file time in NTFS. Set its value
+   into *FT and return true if successfull, otherwise, return false.  */
+
+bool
+currentft (FT *ft)
+{
+  return currentftclock (ft, FT_CLOCK_PRECISE);
+}
+
+/* Get the current time on the clock selected in *FT_CTX as file time in
+   NTFS, which is captured by the first call and returned until the clock
+   is selected again if FT_CLOCK_FROZEN. Set its value into *FT and return
+   true if successfull, otherwise, return false.  */
+
+bool
+currentftctx (FT *ft, FT_CONTEXT *ft_ctx)
+{
+  if (ft_ctx->clock != FT_CLOCK_FROZEN)
+    return currentftclock (ft, ft_ctx->clock);
+  else if (! ft_ctx->frozen_captured)
+    {
+      if (! currentftclock (&ft_ctx->frozen, FT_CLOCK_PRECISE))
+        return false;
+
+      ft_ctx->frozen_captured = true;
+    }
+
+  *ft = ft_ctx->frozen;
+
+  return true;
+}
+
+/* Select the clock used by currentftctx in *FT_CTX.  */
+
+void
+selectftclock (FT_CONTEXT *ft_ctx, int ft_clock)
+{
+  ft_ctx->clock = ft_clock;
+  ft_ctx->frozen_captured = false;
+}
+
 #ifdef TEST
 # include <unistd.h>
 
@@ -56,7 +111,8 @@ usage (int status)
   printusage ("currentft", "\n\
 Display current time " IN_DEFAULT_TIME ".\n\
 \n\
-Options:\n"
+Options:\n\
+  -c   get time from the coarse clock\n"
 # ifdef USE_TM_GLIBC
 "  -v   output time " IN_FILETIME
 # else
@@ -72,6 +128,7 @@ main (int argc, char **argv)
   FT ft;
   intmax_t ft_elapse = 0;
   int ft_frac_val = -1;
+  int ft_clock = FT_CLOCK_PRECISE;
   int c;
   bool success;
   bool seconds_output = false;
@@ -81,10 +138,13 @@ main (int argc, char **argv)
   ft_elapse = -1;
 # endif
 
-  while ((c = getopt (argc, argv, ":sv")) != -1)
+  while ((c = getopt (argc, argv, ":csv")) != -1)
     {
       switch (c)
         {
+        case 'c':
+          ft_clock = FT_CLOCK_COARSE;
+          break;
 # ifdef USE_TM_GLIBC
         case 'v':
           seconds_output = false;
@@ -104,7 +164,7 @@ main (int argc, char **argv)
   if (argc > optind)
     usage (EXIT_FAILURE);
 
-  success = currentft (&ft);
+  success = currentftclock (&ft, ft_clock);
 
   if (success)
     {
@@ -18,6 +18,11 @@
    along with this program; if not, write to the Free Software Foundation,
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
 
+#ifndef FT_H_
+# define FT_H_
+
+#include "ftmodflag.h"
+
 /* The structure into which file time is stored  */
 
 #ifdef USE_TM_GLIBC
@@ -26,11 +31,24 @@ typedef struct timespec FT;
 typedef FILETIME FT;
 #endif
 
+/* The clock from which current time is gotten  */
+
+#define FT_CLOCK_PRECISE 0  /* Precise time at each call */
+#define FT_CLOCK_COARSE  1  /* Faster time updated by the timer tick */
+#define FT_CLOCK_FROZEN  2  /* Time captured at once and reused in a context */
+
 /* Get the current time on system clock as file time in NTFS. Set its value
    into *FT and return true if successfull, otherwise, return false.  */
 
 bool currentft (FT *ft);
 
+/* Get the current time on the specified clock as file time in NTFS. Set its
+   value into *FT and return true if successfull, otherwise, return false.
+   FT_CLOCK_FROZEN is the same as FT_CLOCK_PRECISE because the captured time
+   is kept by the context passed to currentftctx.  */
+
+bool currentftclock (FT *ft, int ft_clock);
+
 /* Convert the specified file time to the value of 100 nanoseconds since
    1601-01-01 00:00 UTC according to FT_MODFLAG. Set its value into *FT_VAL
    and return true if conversion is performed, otherwise, return false.  */
@@ -51,9 +69,9 @@ bool ft2sec (const FT *ft, intmax_t *seconds, int *nsec);
 
 bool sec2ft (intmax_t seconds, int nsec, FT *ft);
 
-/* The size or each index of file times, set in a file  */
+/* The size or each index of file times, gotten from a file  */
 
-#ifdef USE_TM_GLIBC
+#if defined USE_TM_GLIBC && ! defined __linux__
 # define FT_SIZE 2
 #else
 # define FT_SIZE 3
@@ -63,6 +81,26 @@ bool sec2ft (intmax_t seconds, int nsec, FT *ft);
 #define FT_MTIME 1  /* Last write time */
 #define FT_BTIME 2  /* Creation time */
 
+/* The size of file times set in a file, except for the creation time which
+   is never changed on GNU/Linux  */
+
+#ifdef USE_TM_GLIBC
+# define FT_SETTABLE_SIZE 2
+#else
+# define FT_SETTABLE_SIZE FT_SIZE
+#endif
+
+/* The mask of file times gotten from a file  */
+
+#define FT_ATIME_MASK (1 << FT_ATIME)
+#define FT_MTIME_MASK (1 << FT_MTIME)
+#define FT_BTIME_MASK (1 << FT_BTIME)
+
+/* The flag not to synchronize file times with the server on a network
+   filesystem, which may get outdated times faster  */
+
+#define FT_DONT_SYNC 0x100
+
 /* The structure of a file  */
 
 struct file
@@ -83,7 +121,12 @@ struct file
 #ifdef USE_TM_GLIBC
 # define IS_STDOUT_NAME(fname)       (strcmp (fname, "-") == 0)
 # define IS_FILE_STDOUT(f)           IS_STDOUT_NAME ((f)->name)
-# define IS_INVALID_FILE(f,no_dir)   ((f)->fd < 0 && (no_dir || !(f)->isdir))
+/* A file whose time is changed with no_dereference is not opened, but its
+   name is passed to utimensat with AT_SYMLINK_NOFOLLOW, so that the time
+   of a symbolic link or a directory is set by setft or setftctx.  */
+
+# define IS_INVALID_FILE(f,no_dir) \
+    ((f)->fd < 0 && !(f)->no_dereference && (no_dir || !(f)->isdir))
 
 # define INIT_FILE(f,fname,no_deref) \
     f = IS_STDOUT_NAME (fname) \
@@ -116,10 +159,71 @@ struct file
 /* Get file times for the specified struct file into FT and set the flag
    of a directory into the isdir member in *FT_FILE. If the no_dereference
    member is true, get the time of symbolic link but not a file referenced
-   by it. Return true if successfull, otherwise, false.  */
+   by it. On GNU/Linux, set UTIME_OMIT into nanoseconds of the creation time
+   if not supported by the file. Return true if successfull, otherwise,
+   false.  */
 
 bool getft (FT ft[FT_SIZE], struct file *ft_file);
 
+/* Get file times specified by FT_MASK for the specified struct file into
+   FT and set the flag of a directory into the isdir member in *FT_FILE.
+   If FT_DONT_SYNC is set in FT_MASK, don't synchronize those times with
+   the server on a network filesystem. Return true if successfull, or false
+   if failed or any time in FT_MASK is not supported by the file.  */
+
+bool getftmask (FT ft[FT_SIZE], struct file *ft_file, int ft_mask);
+
+#ifdef USE_TM_GLIBC
+/* Get file times specified by FT_MASK for the specified struct file, whose
+   name is relative to the directory referred to by DIRFD, into FT, as with
+   getftmask function. Return true if successfull, otherwise, false.  */
+
+bool getftat (int dirfd, FT ft[FT_SIZE], struct file *ft_file, int ft_mask);
+#endif
+
+/* File times of an entry in a directory  */
+
+struct dirft_entry
+{
+  size_t name_offset;  /* Offset of the name in the names member */
+  FT ft[FT_SIZE];
+  bool isdir;
+};
+
+/* File times of all entries in a directory  */
+
+struct dirft
+{
+  struct dirft_entry *entries;
+  size_t entry_num;
+  size_t entry_alloc;  /* Number of entries allocated */
+#ifdef USE_TM_GLIBC
+  char *names;
+#else
+  WCHAR *names;
+#endif
+  size_t names_size;
+  size_t names_alloc;  /* Number of characters allocated for names */
+};
+
+/* The name of an entry in struct dirft  */
+
+#define DIRFT_NAME(d,i) ((d)->names + (d)->entries[i].name_offset)
+
+/* Get file times specified by FT_MASK for all entries except for "." and
+   ".." in the directory of the specified struct file into *DIR_FT, which
+   must be released by freedirft function. The directory is opened at once
+   and each entry is looked up by the name relative to it. If the
+   no_dereference member is true, fail if the directory is a symbolic link
+   on GNU/Linux, and get the time of symbolic link instead of referenced
+   file for each entry. Return true if successfull, otherwise, false.  */
+
+bool getdirft (struct dirft *dir_ft, struct file *dir_file, int ft_mask);
+
+/* Release memories allocated for the specified struct dirft.  */
+
+void freedirft (struct dirft *dir_ft);
+
 /* The change to file time  */
 
 typedef struct
@@ -162,6 +266,63 @@ typedef struct
   int modflag;  /* Modification flags for file time  */
 } FT_CHANGE;
 
+/* The state of pseudo-random values by which nanoseconds less than a
+   second are modified, whose sequence is the same as rand function in
+   MSVCRT or GNU C Library for the same seed  */
+
+#define FT_RANDSTATE_SIZE 31
+
+typedef struct ft_randstate
+{
+#if defined _WIN32 || defined __CYGWIN__
+  unsigned int value;
+  int complement_bit;
+#else
+  unsigned int table[FT_RANDSTATE_SIZE];
+  int front;
+  int rear;
+#endif
+} FT_RANDSTATE;
+
+/* The context in which file time is calculated, which is owned by each
+   caller and must not be shared by threads at the same time  */
+
+typedef struct
+{
+  /* If DST is in effect or not for a time that is either skipped over or
+     repeated when a transition to or from DST occurs, a positive value or
+     zero, otherwise, a negative value to attempt to determine whether the
+     time is included in the term of DST  */
+  int trans_isdst;
+
+  /* The state of pseudo-random values for FT_NSEC_RANDOM  */
+  FT_RANDSTATE rand;
+
+  /* The clock from which current time is gotten by currentftctx, and the
+     time captured by it for FT_CLOCK_FROZEN if frozen_captured is true  */
+  int clock;
+  bool frozen_captured;
+  FT frozen;
+} FT_CONTEXT;
+
+/* Get the current time on the clock selected in *FT_CTX as file time in
+   NTFS, which is captured by the first call and returned until the clock
+   is selected again if FT_CLOCK_FROZEN. Set its value into *FT and return
+   true if successfull, otherwise, return false.  */
+
+bool currentftctx (FT *ft, FT_CONTEXT *ft_ctx);
+
+/* Select the clock used by currentftctx in *FT_CTX.  */
+
+void selectftclock (FT_CONTEXT *ft_ctx, int ft_clock);
+
+/* Initialize the specified context for the calculation of file time, in
+   which trans_isdst is 1, current time is gotten from FT_CLOCK_PRECISE,
+   and the sequence of pseudo-random values is generated for SEED, or
+   current time if SEED is less than 0.  */
+
+void initftcontext (FT_CONTEXT *ft_ctx, int seed);
+
 /* Calculate file time for *NOW by members in *TM_CHG and set its value
    into *FT. If the datetime_unset member is true, don't calculate and copy
    *NOW changed by the modflag member to *FT. Return true if not overflow,
@@ -169,6 +330,22 @@ typedef struct
 
 bool calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg);
 
+/* Calculate file time for *NOW by members in *TM_CHG in the specified
+   context, as with calcft function. If FT_CTX is NULL, use the context of
+   a process. Return true if not overflow, otherwise, false.  */
+
+bool calcftctx (FT *ft, const FT *now, const FT_CHANGE *ft_chg,
+                FT_CONTEXT *ft_ctx);
+
+/* Calculate file time for *NOW by members in *TM_CHG in the specified
+   context and the time zone of *TZ instead of local time zone, as with
+   calcftctx function. Return true if not overflow, otherwise, false.  */
+
+struct tz_handle;
+
+bool calcft_z (const struct tz_handle *tz, FT *ft, const FT *now,
+               const FT_CHANGE *ft_chg, FT_CONTEXT *ft_ctx);
+
 /* Change the specified file time by members in *TM_CHG and set its value
    to the file specified by *FT_FILE. If TM_CHG is NULL, copy directly it
    to the file, or if a pointer included in FT_NOWP is NULL, set its time
@@ -177,6 +354,14 @@ bool calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg);
 bool setft (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
             const FT_CHANGE *ft_chg);
 
+/* Change the specified file time by members in *TM_CHG in the specified
+   context and set its value to the file specified by *FT_FILE, as with
+   setft function. If FT_CTX is NULL, use the context of a process. Return
+   true if successfull, otherwise, false.  */
+
+bool setftctx (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
+               const FT_CHANGE *ft_chg, FT_CONTEXT *ft_ctx);
+
 /* Parameters parsed from a date and time string, setting file time  */
 
 typedef union
@@ -198,3 +383,13 @@ typedef union
    otherwise, false.  */
 
 bool parseft (FT_PARSING *ft_parsing, const char *str);
+
+/* Load abbreviations of time zones from TZif files under DIR, or TZDIR or
+   "/usr/share/zoneinfo" if NULL, into the index looked up by parseft with
+   local zone abbreviations probed at current time.  Abbreviations used
+   for different UTC offsets or DST flags since 1970 are not loaded.  This
+   must be called before threads are started.  Return true if loaded,
+   otherwise, false.  */
+
+bool loadtzabbrs (const char *dir);
+#endif
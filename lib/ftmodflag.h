@@ -0,0 +1,48 @@
+/* ftmodflag.h -- Modification flags of seconds or nanoseconds less than
+                  a second in file time
+
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef FTMODFLAG_H_
+# define FTMODFLAG_H_
+
+/* Modification flags of seconds or nanoseconds less than a second  */
+
+#define FT_SECONDS_ROUND_UP   1
+#define FT_SECONDS_ROUND_DOWN 2
+#define FT_NSEC_RANDOM        4
+#define FT_NSEC_PERMUTE       8
+
+/* Return true if file time is set by each modification flag  */
+
+#define IS_FT_SECONDS_ROUND_UP(modflag)   (modflag & FT_SECONDS_ROUND_UP)
+#define IS_FT_SECONDS_ROUND_DOWN(modflag) (modflag & FT_SECONDS_ROUND_DOWN)
+#define IS_FT_NSEC_RANDOM(modflag)        (modflag & FT_NSEC_RANDOM)
+#define IS_FT_NSEC_PERMUTE(modflag)       (modflag & FT_NSEC_PERMUTE)
+
+/* Return true if seconds is rounded up or down in file time, according
+   to the specified modification flag  */
+
+#define IS_FT_SECONDS_ROUNDING(modflag) \
+          (modflag & (FT_SECONDS_ROUND_DOWN | FT_SECONDS_ROUND_UP))
+
+/* Return true if the random value is set into nanoseconds less than
+   a second in file time, according to the specified modification flag  */
+
+#define IS_FT_NSEC_RANDOMIZING(modflag) \
+          (modflag & (FT_NSEC_RANDOM | FT_NSEC_PERMUTE))
+#endif
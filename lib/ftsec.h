@@ -16,6 +16,9 @@
    along with this program; if not, write to the Free Software Foundation,
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
 
+#ifndef FTSEC_H_
+# define FTSEC_H_
+
 /* Function to get or set nanoseconds less than a seconds in file time  */
 
 #if defined _WIN32 || defined __CYGWIN__
@@ -46,31 +49,63 @@
 
 bool secoverflow (intmax_t seconds, int nsec);
 
-/* Modification flags of seconds or nanoseconds less than a second  */
+#include <limits.h>
+#include <time.h>
+
+#include "ftmodflag.h"
+#include "ftval.h"
+
+/* Maximum and minimum seconds since 1970-01-01 00:00 UTC, represented
+   by FILETIME in Windows  */
+
+#define FT_SECONDS_MAX \
+  (MAX_SECOND_IN_FILETIME - FILETIME_UNIXEPOCH_VALUE / FILETIME_SECOND_VALUE)
+#define FT_SECONDS_MIN \
+  (MIN_SECOND_IN_FILETIME - FILETIME_UNIXEPOCH_VALUE / FILETIME_SECOND_VALUE)
 
-#define FT_SECONDS_ROUND_UP   1
-#define FT_SECONDS_ROUND_DOWN 2
-#define FT_NSEC_RANDOM        4
-#define FT_NSEC_PERMUTE       8
+/* Maximum 100 nanoseconds less than a second in the maximum seconds  */
 
-/* Return true if file time is set by each modification flag  */
+#define FT_SECONDS_MAX_NSEC \
+  ((int) ((intmax_t)0x7fffffffffffffff % FILETIME_SECOND_VALUE))
 
-#define IS_FT_SECONDS_ROUND_UP(modflag)   (modflag & FT_SECONDS_ROUND_UP)
-#define IS_FT_SECONDS_ROUND_DOWN(modflag) (modflag & FT_SECONDS_ROUND_DOWN)
-#define IS_FT_NSEC_RANDOM(modflag)        (modflag & FT_NSEC_RANDOM)
-#define IS_FT_NSEC_PERMUTE(modflag)       (modflag & FT_NSEC_PERMUTE)
+/* Maximum and minimum value represented by time_t  */
 
-/* Return true if seconds is rounded up or down in file time, according
-   to the specified modification flag  */
+#define TIME_T_MAX \
+  ((((intmax_t) 1 << (sizeof (time_t) * CHAR_BIT - 2)) - 1) * 2 + 1)
+#define TIME_T_MIN (~ TIME_T_MAX)
 
-#define IS_FT_SECONDS_ROUNDING(modflag) \
-          (modflag & (FT_SECONDS_ROUND_DOWN | FT_SECONDS_ROUND_UP))
+/* Inline version of secoverflow function, which is called instead of it
+   if USE_TM_INLINE is defined  */
 
-/* Return true if the random value is set into nanoseconds less than
-   a second in file time, according to the specified modification flag  */
+static inline bool
+secoverflow_inline (intmax_t seconds, int nsec)
+{
+  if (seconds >= 0)
+    {
+# if !defined _WIN32 && !defined __CYGWIN__
+      nsec /= FT_NSEC_PRECISION / FILETIME_SECOND_VALUE;  /* for GNU/Linx */
+# endif
 
-#define IS_FT_NSEC_RANDOMIZING(modflag) \
-          (modflag & (FT_NSEC_RANDOM | FT_NSEC_PERMUTE))
+      return TIME_T_MAX < FT_SECONDS_MAX ? seconds > TIME_T_MAX
+             : (seconds > FT_SECONDS_MAX
+                || (seconds == FT_SECONDS_MAX && nsec > FT_SECONDS_MAX_NSEC));
+    }
+
+  seconds++;
+  nsec = FT_NSEC_PRECISION - nsec;
+# if !defined _WIN32 && !defined __CYGWIN__
+  nsec /= FT_NSEC_PRECISION / FILETIME_SECOND_VALUE;  /* for GNU/Linx */
+# endif
+
+  return TIME_T_MIN > FT_SECONDS_MIN ? seconds < TIME_T_MIN
+         : (seconds < FT_SECONDS_MIN
+            || (seconds == FT_SECONDS_MIN
+                && nsec > FT_SECONDS_MAX_NSEC + 1));
+}
+
+#ifdef USE_TM_INLINE
+# define secoverflow(seconds,nsec) secoverflow_inline (seconds, nsec)
+#endif
 
 /* Modify the specified value of seconds since 1970-01-01 00:00 UTC and
    nanoseconds less than a second, according to MODFLAG. Set its two values
@@ -79,8 +114,56 @@ bool secoverflow (intmax_t seconds, int nsec);
 
 bool modifysec (intmax_t *seconds, int *nsec, int modflag);
 
+/* Modify the specified value of seconds since 1970-01-01 00:00 UTC and
+   nanoseconds less than a second, according to MODFLAG, as with modifysec
+   function, but generate pseudo-random values by *STATE. Return true if
+   *NSEC is not less than 0 and modification is performed, otherwise,
+   return false.  */
+
+struct ft_randstate;
+
+bool modifysecr (intmax_t *seconds, int *nsec, int modflag,
+                 struct ft_randstate *state);
+
 /* Generate a new sequence of pseudo-random values for the specified seed
    number in the modification of nanoseconds less than a second. If SEED
    is less than 0, use current time instead.  */
 
 void srandsec (int seed);
+
+/* Generate a new sequence of pseudo-random values for the specified seed
+   number into *STATE, as with srandsec function.  */
+
+void srandsecr (struct ft_randstate *state, int seed);
+
+/* Parse the specified argument as the date, time, and UTC offset in
+   ISO 8601 format and set seconds since 1970-01-01 00:00 UTC and
+   nanoseconds less than a second into *SECONDS and *NSEC, which are
+   calculated directly by days elapsed from the date without adjusting
+   by the time zone. Return 1 if set, 0 if not in the format of
+   "YYYY-MM-DDThh:mm:ss[.nnnnnnnnn]" and "Z", "+hhmm", or "-hhmm",
+   otherwise, -1 if a value is outside the range of its parameter.  */
+
+int iso8601sec (const char *arg, intmax_t *seconds, int *nsec);
+
+/* The record of seconds since 1970-01-01 00:00 UTC and nanoseconds less
+   than a second, which is -1 if not converted  */
+
+struct secrec
+{
+  intmax_t seconds;
+  int nsec;
+};
+
+/* Convert the first field of lines, separated by a space or tab, in BUF
+   of SIZE bytes from ISO 8601 format into records of seconds since
+   1970-01-01 00:00 UTC and nanoseconds less than a second as with
+   iso8601sec function, and set those values into RECS up to REC_NUM.
+   The field and newline of converted lines are terminated by the null
+   character in BUF. Store the pointer to the line not converted because
+   its newline is not included in BUF or RECS is filled into *ENDPTR.
+   Return the number of converted lines.  */
+
+size_t iso8601secs (char *buf, size_t size,
+                    struct secrec *recs, size_t rec_num, char **endptr);
+#endif
@@ -0,0 +1,333 @@
+/* Get file times of all entries in a directory
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#include "config.h"
+
+#ifdef USE_TM_GLIBC
+# include <dirent.h>
+# include <errno.h>
+# include <fcntl.h>
+# include <time.h>
+# include <unistd.h>
+# ifdef __linux__
+#  include <sys/syscall.h>
+# endif
+#else
+# ifndef UNICODE
+#  define UNICODE
+# endif
+# include <windows.h>
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ft.h"
+
+#ifdef USE_TM_GLIBC
+typedef char NAMECHAR;
+#else
+typedef WCHAR NAMECHAR;
+#endif
+
+/* The initial number of entries and characters of names allocated
+   for struct dirft  */
+#define DIRFT_ENTRY_INITIAL 64
+#define DIRFT_NAMES_INITIAL 1024
+
+/* Return true if the specified name is "." or "..".  */
+static inline bool
+is_dot_or_dotdot (const NAMECHAR *name)
+{
+  return name[0] == '.' && (name[1] == '\0'
+                            || (name[1] == '.' && name[2] == '\0'));
+}
+
+/* Append the specified name of LEN characters and a new entry into
+   *DIR_FT. Return the pointer to its entry if successfull, otherwise,
+   NULL.  */
+static struct dirft_entry *
+add_dirft_entry (struct dirft *dir_ft, const NAMECHAR *name, size_t len)
+{
+  if (dir_ft->entry_num >= dir_ft->entry_alloc)
+    {
+      size_t alloc = dir_ft->entry_alloc * 2;
+      struct dirft_entry *entries =
+        realloc (dir_ft->entries, sizeof (struct dirft_entry) * alloc);
+      if (! entries)
+        return NULL;
+
+      dir_ft->entries = entries;
+      dir_ft->entry_alloc = alloc;
+    }
+
+  if (dir_ft->names_size + len + 1 > dir_ft->names_alloc)
+    {
+      size_t alloc = dir_ft->names_alloc * 2;
+      while (dir_ft->names_size + len + 1 > alloc)
+        alloc *= 2;
+
+      NAMECHAR *names = realloc (dir_ft->names, sizeof (NAMECHAR) * alloc);
+      if (! names)
+        return NULL;
+
+      dir_ft->names = names;
+      dir_ft->names_alloc = alloc;
+    }
+
+  struct dirft_entry *entry = dir_ft->entries + dir_ft->entry_num;
+  entry->name_offset = dir_ft->names_size;
+  entry->isdir = false;
+
+  memcpy (dir_ft->names + dir_ft->names_size, name, sizeof (NAMECHAR) * len);
+  dir_ft->names[dir_ft->names_size + len] = '\0';
+
+  return entry;
+}
+
+#ifdef USE_TM_GLIBC
+/* Get file times of the entry named NAME in the directory referred to by
+   DIRFD and append it into *DIR_FT. Return 1 if successfull, 0 if it has
+   been removed, otherwise, -1.  */
+static int
+getdirft_entry (struct dirft *dir_ft, int dirfd, const char *name,
+                bool no_dereference, int ft_mask)
+{
+  size_t len = strlen (name);
+  struct dirft_entry *entry = add_dirft_entry (dir_ft, name, len);
+  if (! entry)
+    return -1;
+
+  /* Never treat the entry named "-" as standard output by INIT_FILE. */
+  struct file ft_file =
+    (struct file) { .name = DIRFT_NAME (dir_ft, dir_ft->entry_num),
+                    .fd = -1, .no_dereference = no_dereference,
+                    .isdir = false };
+
+  if (! getftat (dirfd, entry->ft, &ft_file, ft_mask))
+    return errno == ENOENT ? 0 : -1;
+
+  entry->isdir = ft_file.isdir;
+  dir_ft->names_size += len + 1;
+  dir_ft->entry_num++;
+
+  return 1;
+}
+
+# ifdef SYS_getdents64
+/* The entry of a directory read by getdents64 system call  */
+struct linux_dirent64
+{
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+/* The size of buffer into which entries of a directory are read  */
+#  define DIRENT_BUFSIZE 32768
+# endif
+#endif
+
+/* Get file times specified by FT_MASK for all entries except for "." and
+   ".." in the directory of the specified struct file into *DIR_FT, which
+   must be released by freedirft function. The directory is opened at once
+   and each entry is looked up by the name relative to it. If the
+   no_dereference member is true, fail if the directory is a symbolic link
+   on GNU/Linux, and get the time of symbolic link instead of referenced
+   file for each entry. Return true if successfull, otherwise, false.  */
+
+bool
+getdirft (struct dirft *dir_ft, struct file *dir_file, int ft_mask)
+{
+  bool success = true;
+
+  dir_ft->entry_alloc = DIRFT_ENTRY_INITIAL;
+  dir_ft->entries = malloc (sizeof (struct dirft_entry) * dir_ft->entry_alloc);
+  dir_ft->entry_num = 0;
+  dir_ft->names_alloc = DIRFT_NAMES_INITIAL;
+  dir_ft->names = malloc (sizeof (NAMECHAR) * dir_ft->names_alloc);
+  dir_ft->names_size = 0;
+
+  if (! dir_ft->entries || ! dir_ft->names)
+    {
+      freedirft (dir_ft);
+      return false;
+    }
+
+#ifdef USE_TM_GLIBC
+  int fd = open (dir_file->name,
+                 O_RDONLY | O_DIRECTORY | O_CLOEXEC
+                 | (dir_file->no_dereference ? O_NOFOLLOW : 0));
+  if (fd < 0)
+    {
+      freedirft (dir_ft);
+      return false;
+    }
+
+  dir_file->isdir = true;
+
+# ifdef SYS_getdents64
+  /* Read entries by the system call directly instead of readdir function
+     because their names are only needed. */
+  char *buf = malloc (DIRENT_BUFSIZE);
+  if (! buf)
+    success = false;
+
+  while (success)
+    {
+      long n = syscall (SYS_getdents64, fd, buf, DIRENT_BUFSIZE);
+      long pos;
+
+      if (n <= 0)
+        {
+          success = n == 0;
+          break;
+        }
+
+      for (pos = 0; pos < n; )
+        {
+          struct linux_dirent64 *d = (struct linux_dirent64 *)(buf + pos);
+          pos += d->d_reclen;
+
+          if (! is_dot_or_dotdot (d->d_name)
+              && getdirft_entry (dir_ft, fd, d->d_name,
+                                 dir_file->no_dereference, ft_mask) < 0)
+            {
+              success = false;
+              break;
+            }
+        }
+    }
+
+  free (buf);
+  close (fd);
+# else
+  DIR *dirp = fdopendir (fd);
+  if (! dirp)
+    {
+      close (fd);
+      success = false;
+    }
+  else
+    {
+      struct dirent *d;
+
+      errno = 0;
+      while ((d = readdir (dirp)) != NULL)
+        {
+          if (! is_dot_or_dotdot (d->d_name)
+              && getdirft_entry (dir_ft, fd, d->d_name,
+                                 dir_file->no_dereference, ft_mask) < 0)
+            break;
+          errno = 0;
+        }
+
+      success = errno == 0;
+      closedir (dirp);
+    }
+# endif
+#else
+  size_t dirname_len = wcslen (dir_file->name);
+  WCHAR *pattern = malloc (sizeof (WCHAR) * (dirname_len + 3));
+  if (! pattern)
+    {
+      freedirft (dir_ft);
+      return false;
+    }
+
+  /* Find all entries by "DIRNAME\*", which return their times without
+     opening each file. */
+  memcpy (pattern, dir_file->name, sizeof (WCHAR) * dirname_len);
+  if (dirname_len > 0 && pattern[dirname_len - 1] != L'\\'
+      && pattern[dirname_len - 1] != L'/')
+    pattern[dirname_len++] = L'\\';
+  pattern[dirname_len++] = L'*';
+  pattern[dirname_len] = L'\0';
+
+  WIN32_FIND_DATAW fdata;
+# if _WIN32_WINNT >= 0x0601
+  /* Don't query short names and use larger buffer on Windows 7 or later. */
+  HANDLE hFind = FindFirstFileExW (pattern, FindExInfoBasic, &fdata,
+                                   FindExSearchNameMatch, NULL,
+                                   FIND_FIRST_EX_LARGE_FETCH);
+# else
+  HANDLE hFind = FindFirstFileW (pattern, &fdata);
+# endif
+  free (pattern);
+
+  if (hFind == INVALID_HANDLE_VALUE)
+    success = false;
+  else
+    {
+      dir_file->isdir = true;
+
+      do
+        {
+          if (! is_dot_or_dotdot (fdata.cFileName))
+            {
+              size_t len = wcslen (fdata.cFileName);
+              struct dirft_entry *entry =
+                add_dirft_entry (dir_ft, fdata.cFileName, len);
+              if (! entry)
+                {
+                  success = false;
+                  break;
+                }
+
+              entry->ft[FT_ATIME] = fdata.ftLastAccessTime;
+              entry->ft[FT_MTIME] = fdata.ftLastWriteTime;
+              entry->ft[FT_BTIME] = fdata.ftCreationTime;
+              entry->isdir =
+                (fdata.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+
+              dir_ft->names_size += len + 1;
+              dir_ft->entry_num++;
+            }
+        }
+      while (FindNextFileW (hFind, &fdata));
+
+      if (success && GetLastError () != ERROR_NO_MORE_FILES)
+        success = false;
+
+      FindClose (hFind);
+    }
+#endif
+
+  if (!success)
+    freedirft (dir_ft);
+
+  return success;
+}
+
+/* Release memories allocated for the specified struct dirft.  */
+
+void
+freedirft (struct dirft *dir_ft)
+{
+  free (dir_ft->entries);
+  free (dir_ft->names);
+
+  dir_ft->entries = NULL;
+  dir_ft->entry_num = 0;
+  dir_ft->entry_alloc = 0;
+  dir_ft->names = NULL;
+  dir_ft->names_size = 0;
+  dir_ft->names_alloc = 0;
+}
@@ -15,9 +15,16 @@
    along with this program; if not, write to the Free Software Foundation,
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
 
+#ifndef _GNU_SOURCE
+/* Set the macro to declare statx function on GNU/Linux  */
+# define _GNU_SOURCE
+#endif
+
 #include "config.h"
 
 #ifdef USE_TM_GLIBC
+# include <errno.h>
+# include <fcntl.h>
 # include <sys/stat.h>
 # include <time.h>
 #else
@@ -30,29 +37,139 @@
 #include <stdint.h>
 
 #include "ft.h"
+#include "timeutils.h"
+
+#if defined USE_TM_GLIBC && defined STATX_BTIME
+/* Set file times of the specified mask in *STX into FT. If the creation
+   time is not supported by the file, set UTIME_OMIT into its nanoseconds.
+   Return true if all times in FT_MASK are gotten, otherwise, false.  */
+static bool
+statxft (FT ft[FT_SIZE], const struct statx *stx, int ft_mask)
+{
+  unsigned int stx_masks[] = { STATX_ATIME, STATX_MTIME, STATX_BTIME };
+  const struct statx_timestamp *stx_times[] =
+    { &stx->stx_atime, &stx->stx_mtime, &stx->stx_btime };
+  int i;
+
+  for (i = 0; i < FT_SIZE; i++)
+    {
+      if (stx->stx_mask & stx_masks[i])
+        {
+          ft[i].tv_sec = stx_times[i]->tv_sec;
+          ft[i].tv_nsec = stx_times[i]->tv_nsec;
+        }
+      else if (ft_mask & (1 << i))
+        return false;
+      else
+        {
+          ft[i].tv_sec = 0;
+          ft[i].tv_nsec = UTIME_OMIT;
+        }
+    }
+
+  return true;
+}
+
+/* Whether statx function is not implemented by the kernel  */
+static bool statx_unsupported = false;
+#endif
 
 /* Get file times for the specified struct file into FT and set the flag
    of a directory into the isdir member in *FT_FILE. If the no_dereference
    member is true, get the time of symbolic link but not a file referenced
-   by it. Return true if successfull, otherwise, false.  */
+   by it. On GNU/Linux, set UTIME_OMIT into nanoseconds of the creation time
+   if not supported by the file. Return true if successfull, otherwise,
+   false.  */
 
 bool
 getft (FT ft[FT_SIZE], struct file *ft_file)
 {
+  return getftmask (ft, ft_file, FT_ATIME_MASK | FT_MTIME_MASK);
+}
+
 #ifdef USE_TM_GLIBC
+/* Get file times specified by FT_MASK for the specified struct file, whose
+   name is relative to the directory referred to by DIRFD, into FT, as with
+   getftmask function. Return true if successfull, otherwise, false.  */
+
+bool
+getftat (int dirfd, FT ft[FT_SIZE], struct file *ft_file, int ft_mask)
+{
   struct stat st;
+  int atflag = ft_file->no_dereference ? AT_SYMLINK_NOFOLLOW : 0;
+
+# ifdef STATX_BTIME
+  if (!statx_unsupported)
+    {
+      struct statx stx;
+
+      /* Request only the type and times because other fields may need
+         more costs to be gotten on some filesystems. */
+      if (ft_mask & FT_DONT_SYNC)
+        atflag |= AT_STATX_DONT_SYNC;
+
+      if (statx (dirfd, ft_file->name, atflag,
+                 STATX_TYPE | STATX_ATIME | STATX_MTIME | STATX_BTIME,
+                 &stx) == 0)
+        {
+          if (! statxft (ft, &stx, ft_mask))
+            {
+              errno = ENODATA;
+              return false;
+            }
 
-  if ((ft_file->no_dereference
-       ? lstat (ft_file->name, &st) : stat (ft_file->name, &st)) == 0)
+          if (S_ISDIR (stx.stx_mode))
+            ft_file->isdir = true;
+
+          return true;
+        }
+      else if (errno != ENOSYS)
+        return false;
+
+      statx_unsupported = true;
+      atflag &= ~AT_STATX_DONT_SYNC;
+    }
+# endif
+
+# if FT_SIZE > FT_BTIME
+  /* Never get the creation time by fstatat function. */
+  if (ft_mask & FT_BTIME_MASK)
+    {
+      errno = ENODATA;
+      return false;
+    }
+# endif
+
+  if (fstatat (dirfd, ft_file->name, &st, atflag) == 0)
     {
       ft[FT_ATIME] = st.st_atim;
       ft[FT_MTIME] = st.st_mtim;
+# if FT_SIZE > FT_BTIME
+      ft[FT_BTIME].tv_sec = 0;
+      ft[FT_BTIME].tv_nsec = UTIME_OMIT;
+# endif
 
       if (S_ISDIR (st.st_mode))
         ft_file->isdir = true;
 
       return true;
     }
+
+  return false;
+}
+#endif
+
+/* Get file times specified by FT_MASK for the specified struct file into
+   FT and set the flag of a directory into the isdir member in *FT_FILE.
+   If FT_DONT_SYNC is set in FT_MASK, don't synchronize those times with
+   the server on a network filesystem. Return true if successfull, or false
+   if failed or any time in FT_MASK is not supported by the file.  */
+
+bool
+getftmask (FT ft[FT_SIZE], struct file *ft_file, int ft_mask)
+{
+#ifdef USE_TM_GLIBC
+  return getftat (AT_FDCWD, ft, ft_file, ft_mask);
 #else
   WIN32_FILE_ATTRIBUTE_DATA finfo;
 
@@ -67,12 +184,13 @@ getft (FT ft[FT_SIZE], struct file *ft_file)
 
       return true;
     }
-#endif
 
   return false;
+#endif
 }
 
 #ifdef TEST
+# include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
 # include <unistd.h>
@@ -99,11 +217,15 @@ Options:\n"
   -a        output the access time\n"
 # else
 "\
-  -a        output the last access time\n\
+  -a        output the last access time\n"
+# endif
+# if FT_SIZE > FT_BTIME
+"\
   -b        output the creation time\n"
 # endif
 "\
   -C        round up to the smallest second that is not less than time\n\
+  -D        output time of all files in the directory FILE\n\
   -F        round down to the largest second that does not exceed time\n"
 # ifdef USE_TM_GLIBC
 "\
@@ -118,6 +240,7 @@ Options:\n"
   -R SEED   change nanoseconds at random by SEED; If 0, use current time\n"
 # ifdef USE_TM_GLIBC
 "\
+  -S        don't synchronize time with the server on network filesystem\n\
   -v        output time " IN_FILETIME
 # else
 "\
@@ -127,6 +250,36 @@ Options:\n"
   exit (status);
 }
 
+/* Output the specified file time to standard output, modified by MODFLAG.
+   If NO_NEWLINE is true, don't output the trailing newline. Return true if
+   successfull, otherwise, false.  */
+static bool
+printft (const FT *ftp, bool seconds_output, int modflag, bool no_newline)
+{
+  intmax_t ft_elapse = 0;
+  int ft_frac_val = -1;
+  bool success;
+
+  if (seconds_output)  /* Seconds since 1970-01-01 00:00 UTC */
+    {
+      int frac_val;
+
+      success = ft2sec (ftp, &ft_elapse, &frac_val)
+                && (!modflag || modifysec (&ft_elapse, &frac_val, modflag));
+
+      if (success)
+        ft_frac_val = frac_val;
+      else
+        ft_elapse = -1;
+    }
+  else  /* 100 nanoseconds since 1601-01-01 00:00 UTC */
+    success = ft2val (ftp, modflag, &ft_elapse);
+
+  printelapse (no_newline, ft_elapse, ft_frac_val);
+
+  return success;
+}
+
 # ifndef USE_TM_GLIBC
 LPWSTR *wargv = NULL;
 # endif
@@ -136,9 +289,8 @@ main (int argc, char **argv)
 {
   struct file ft_file;
   FT ft[FT_SIZE];
-  FT *ftp = ft + FT_MTIME;
-  intmax_t ft_elapse = 0;
-  int ft_frac_val = -1;
+  int ftind = FT_MTIME;
+  int ft_mask = 0;
   int modflag = 0;
   int seed = 0;
   int c;
@@ -146,45 +298,51 @@ main (int argc, char **argv)
   char *endptr;
   bool success = true;
   bool seconds_output = false;
+  bool dir_output = false;
 # ifdef USE_TM_GLIBC
   bool no_dereference = false;
 
   seconds_output = true;
-  ft_elapse = -1;
 # endif
 
-  while ((c = getopt (argc, argv, ":abCFhmPR:sv")) != -1)
+  while ((c = getopt (argc, argv, ":abCDFhmPR:sSv")) != -1)
     {
       switch (c)
         {
         case 'a':
-          ftp = ft + FT_ATIME;
+          ftind = FT_ATIME;
           break;
-# ifndef USE_TM_GLIBC
+# if FT_SIZE > FT_BTIME
         case 'b':
-          ftp = ft + FT_BTIME;
+          ftind = FT_BTIME;
           break;
+# endif
+# ifndef USE_TM_GLIBC
         case 's':
           seconds_output = true;
-          ft_elapse = -1;
           break;
 # else
         case 'h':
           no_dereference = true;
           break;
+        case 'S':
+          ft_mask |= FT_DONT_SYNC;
+          break;
         case 'v':
           seconds_output = false;
-          ft_elapse = 0;
           break;
 # endif
         case 'C':
           modflag |= FT_SECONDS_ROUND_UP;
           break;
+        case 'D':
+          dir_output = true;
+          break;
         case 'F':
           modflag |= FT_SECONDS_ROUND_DOWN;
           break;
         case 'm':
-          ftp = ft + FT_MTIME;
+          ftind = FT_MTIME;
           break;
         case 'P':
           modflag |= FT_NSEC_PERMUTE;
@@ -219,29 +377,48 @@ main (int argc, char **argv)
   INIT_FILE (ft_file, wargv[optind], false);
 # endif
 
-  if (! getft (ft, &ft_file))
-    errfile (EXIT_FAILURE, ERRNO (), "failed to get attributes of", &ft_file);
+  ft_mask |= 1 << ftind;
 
-  /* Generate a new sequence at once before get random values. */
-  if (IS_FT_NSEC_RANDOMIZING (modflag))
-    srandsec (--seed);
-
-  if (seconds_output)  /* Seconds since 1970-01-01 00:00 UTC */
+  if (dir_output)
     {
-      int frac_val;
+      struct dirft dir_ft;
+      size_t i;
 
-      success = ft2sec (ftp, &ft_elapse, &frac_val)
-                && (!modflag || modifysec (&ft_elapse, &frac_val, modflag));
+      if (! getdirft (&dir_ft, &ft_file, ft_mask))
+        errfile (EXIT_FAILURE, ERRNO (), "failed to read directory", &ft_file);
 
-      if (success)
-        ft_frac_val = frac_val;
-      else
-        ft_elapse = -1;
+      /* Generate a new sequence at once before get random values. */
+      if (IS_FT_NSEC_RANDOMIZING (modflag))
+        srandsec (--seed);
+
+      for (i = 0; i < dir_ft.entry_num; i++)
+        {
+          success &= printft (dir_ft.entries[i].ft + ftind,
+                              seconds_output, modflag, true);
+# ifdef USE_TM_GLIBC
+          printf (" %s", DIRFT_NAME (&dir_ft, i));
+# else
+          printf (" %ls", DIRFT_NAME (&dir_ft, i));
+# endif
+          if (dir_ft.entries[i].isdir)
+            fputc ('/', stdout);
+          fputc ('\n', stdout);
+        }
+
+      freedirft (&dir_ft);
     }
-  else  /* 100 nanoseconds since 1601-01-01 00:00 UTC */
-    success = ft2val (ftp, modflag, &ft_elapse);
+  else
+    {
+      if (! getftmask (ft, &ft_file, ft_mask))
+        errfile (EXIT_FAILURE, ERRNO (),
+                 "failed to get attributes of", &ft_file);
+
+      /* Generate a new sequence at once before get random values. */
+      if (IS_FT_NSEC_RANDOMIZING (modflag))
+        srandsec (--seed);
 
-  printelapse (false, ft_elapse, ft_frac_val);
+      success = printft (ft + ftind, seconds_output, modflag, false);
+    }
 
 # ifndef USE_TM_GLIBC
   LocalFree (wargv);
@@ -18,6 +18,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "imaxoverflow.h"
+
 /* Check whether the result value overflows from the range of intmax_t
    by the addition of the specified A and B. Return false and set its
    value into *P if don't overflow, otherwise, return true.  */
@@ -25,10 +27,7 @@
 bool
 imax_add_overflow (intmax_t a, intmax_t b, intmax_t *p)
 {
-  if (b > 0 ? a > INTMAX_MAX - b : a < INTMAX_MIN - b)
-    return true;
-  *p = a + b;
-  return false;
+  return imax_add_overflow_inline (a, b, p);
 }
 
 /* Check whether the result value overflows from the range of intmax_t
@@ -38,10 +37,7 @@ imax_add_overflow (intmax_t a, intmax_t b, intmax_t *p)
 bool
 imax_sub_overflow (intmax_t a, intmax_t b, intmax_t *p)
 {
-  if (b < 0 ? a > INTMAX_MAX + b : a < INTMAX_MIN + b)
-    return true;
-  *p = a - b;
-  return false;
+  return imax_sub_overflow_inline (a, b, p);
 }
 
 /* Check whether the result value overflows from the range of intmax_t
@@ -51,12 +47,5 @@ imax_sub_overflow (intmax_t a, intmax_t b, intmax_t *p)
 bool
 imax_mul_overflow (intmax_t a, intmax_t b, intmax_t *p)
 {
-  if (b > 0
-     ? (a > INTMAX_MAX / b) || (a < INTMAX_MIN / b)
-     : (b < -1
-        ? (a > INTMAX_MIN / b) || (a < INTMAX_MAX / b)
-        : b == -1 && a == INTMAX_MIN))
-    return true;
-  *p = a * b;
-  return false;
+  return imax_mul_overflow_inline (a, b, p);
 }
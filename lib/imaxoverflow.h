@@ -16,10 +16,29 @@
    along with this program; if not, write to the Free Software Foundation,
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
 
-/* Macro definitions for overflow function  */
-#define IMAX_ADD_WRAPV(a,b,p)      imax_add_overflow (a, b, p)
-#define IMAX_SUBTRACT_WRAPV(a,b,p) imax_sub_overflow (a, b, p)
-#define IMAX_MULTIPLY_WRAPV(a,b,p) imax_mul_overflow (a, b, p)
+#ifndef IMAXOVERFLOW_H_
+# define IMAXOVERFLOW_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Return true if the compiler has built-in functions to check overflow  */
+# if ! defined HAVE_BUILTIN_OVERFLOW \
+     && ((defined __GNUC__ && __GNUC__ >= 5) || defined __clang__)
+#  define HAVE_BUILTIN_OVERFLOW 1
+# endif
+
+/* Macro definitions for overflow function, expanded inline if
+   USE_TM_INLINE is defined  */
+# ifdef USE_TM_INLINE
+#  define IMAX_ADD_WRAPV(a,b,p)      imax_add_overflow_inline (a, b, p)
+#  define IMAX_SUBTRACT_WRAPV(a,b,p) imax_sub_overflow_inline (a, b, p)
+#  define IMAX_MULTIPLY_WRAPV(a,b,p) imax_mul_overflow_inline (a, b, p)
+# else
+#  define IMAX_ADD_WRAPV(a,b,p)      imax_add_overflow (a, b, p)
+#  define IMAX_SUBTRACT_WRAPV(a,b,p) imax_sub_overflow (a, b, p)
+#  define IMAX_MULTIPLY_WRAPV(a,b,p) imax_mul_overflow (a, b, p)
+# endif
 
 /* Check whether the result value overflows from the range of intmax_t
    by the addition of the specified A and B. Return false and set its
@@ -38,3 +57,59 @@ bool imax_sub_overflow (intmax_t a, intmax_t b, intmax_t *p);
    its value into *P if don't overflow, otherwise, return true.  */
 
 bool imax_mul_overflow (intmax_t a, intmax_t b, intmax_t *p);
+
+/* Inline versions of the above functions, which never change *P if
+   overflow as with those  */
+
+static inline bool
+imax_add_overflow_inline (intmax_t a, intmax_t b, intmax_t *p)
+{
+# ifdef HAVE_BUILTIN_OVERFLOW
+  intmax_t r;
+  if (__builtin_add_overflow (a, b, &r))
+    return true;
+  *p = r;
+# else
+  if (b > 0 ? a > INTMAX_MAX - b : a < INTMAX_MIN - b)
+    return true;
+  *p = a + b;
+# endif
+  return false;
+}
+
+static inline bool
+imax_sub_overflow_inline (intmax_t a, intmax_t b, intmax_t *p)
+{
+# ifdef HAVE_BUILTIN_OVERFLOW
+  intmax_t r;
+  if (__builtin_sub_overflow (a, b, &r))
+    return true;
+  *p = r;
+# else
+  if (b < 0 ? a > INTMAX_MAX + b : a < INTMAX_MIN + b)
+    return true;
+  *p = a - b;
+# endif
+  return false;
+}
+
+static inline bool
+imax_mul_overflow_inline (intmax_t a, intmax_t b, intmax_t *p)
+{
+# ifdef HAVE_BUILTIN_OVERFLOW
+  intmax_t r;
+  if (__builtin_mul_overflow (a, b, &r))
+    return true;
+  *p = r;
+# else
+  if (b > 0
+     ? (a > INTMAX_MAX / b) || (a < INTMAX_MIN / b)
+     : (b < -1
+        ? (a > INTMAX_MIN / b) || (a < INTMAX_MAX / b)
+        : b == -1 && a == INTMAX_MIN))
+    return true;
+  *p = a * b;
+# endif
+  return false;
+}
+#endif
@@ -18,6 +18,8 @@
 #include <limits.h>
 #include <stdbool.h>
 
+#include "intoverflow.h"
+
 /* Check whether the result value overflows from the range of integer
    by the addition of the specified A and B. Return false and set its
    value into *P if don't overflow, otherwise, return true.  */
@@ -25,10 +27,7 @@
 bool
 int_add_overflow (int a, int b, int *p)
 {
-  if (b > 0 ? a > INT_MAX - b : a < INT_MIN - b)
-    return true;
-  *p = a + b;
-  return false;
+  return int_add_overflow_inline (a, b, p);
 }
 
 /* Check whether the result value overflows from the range of integer
@@ -38,10 +37,7 @@ int_add_overflow (int a, int b, int *p)
 bool
 int_sub_overflow (int a, int b, int *p)
 {
-  if (b < 0 ? a > INT_MAX + b : a < INT_MIN + b)
-    return true;
-  *p = a - b;
-  return false;
+  return int_sub_overflow_inline (a, b, p);
 }
 
 /* Check whether the result value overflows from the range of integer
@@ -51,12 +47,5 @@ int_sub_overflow (int a, int b, int *p)
 bool
 int_mul_overflow (int a, int b, int *p)
 {
-  if (b > 0
-     ? (a > INT_MAX / b) || (a < INT_MIN / b)
-     : (b < -1
-        ? (a > INT_MIN / b) || (a < INT_MAX / b)
-        : b == -1 && a == INT_MIN))
-    return true;
-  *p = a * b;
-  return false;
+  return int_mul_overflow_inline (a, b, p);
 }
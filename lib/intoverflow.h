@@ -16,10 +16,29 @@
    along with this program; if not, write to the Free Software Foundation,
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
 
-/* Macro definitions for overflow function  */
-#define INT_ADD_WRAPV(a,b,p)      int_add_overflow (a, b, p)
-#define INT_SUBTRACT_WRAPV(a,b,p) int_sub_overflow (a, b, p)
-#define INT_MULTIPLY_WRAPV(a,b,p) int_mul_overflow (a, b, p)
+#ifndef INTOVERFLOW_H_
+# define INTOVERFLOW_H_
+
+#include <limits.h>
+#include <stdbool.h>
+
+/* Return true if the compiler has built-in functions to check overflow  */
+# if ! defined HAVE_BUILTIN_OVERFLOW \
+     && ((defined __GNUC__ && __GNUC__ >= 5) || defined __clang__)
+#  define HAVE_BUILTIN_OVERFLOW 1
+# endif
+
+/* Macro definitions for overflow function, expanded inline if
+   USE_TM_INLINE is defined  */
+# ifdef USE_TM_INLINE
+#  define INT_ADD_WRAPV(a,b,p)      int_add_overflow_inline (a, b, p)
+#  define INT_SUBTRACT_WRAPV(a,b,p) int_sub_overflow_inline (a, b, p)
+#  define INT_MULTIPLY_WRAPV(a,b,p) int_mul_overflow_inline (a, b, p)
+# else
+#  define INT_ADD_WRAPV(a,b,p)      int_add_overflow (a, b, p)
+#  define INT_SUBTRACT_WRAPV(a,b,p) int_sub_overflow (a, b, p)
+#  define INT_MULTIPLY_WRAPV(a,b,p) int_mul_overflow (a, b, p)
+# endif
 
 /* Check whether the result value overflows from the range of integer
    by the addition of the specified A and B. Return false and set its
@@ -38,3 +57,59 @@ bool int_sub_overflow (int a, int b, int *p);
    its value into *P if don't overflow, otherwise, return true.  */
 
 bool int_mul_overflow (int a, int b, int *p);
+
+/* Inline versions of the above functions, which never change *P if
+   overflow as with those  */
+
+static inline bool
+int_add_overflow_inline (int a, int b, int *p)
+{
+# ifdef HAVE_BUILTIN_OVERFLOW
+  int r;
+  if (__builtin_add_overflow (a, b, &r))
+    return true;
+  *p = r;
+# else
+  if (b > 0 ? a > INT_MAX - b : a < INT_MIN - b)
+    return true;
+  *p = a + b;
+# endif
+  return false;
+}
+
+static inline bool
+int_sub_overflow_inline (int a, int b, int *p)
+{
+# ifdef HAVE_BUILTIN_OVERFLOW
+  int r;
+  if (__builtin_sub_overflow (a, b, &r))
+    return true;
+  *p = r;
+# else
+  if (b < 0 ? a > INT_MAX + b : a < INT_MIN + b)
+    return true;
+  *p = a - b;
+# endif
+  return false;
+}
+
+static inline bool
+int_mul_overflow_inline (int a, int b, int *p)
+{
+# ifdef HAVE_BUILTIN_OVERFLOW
+  int r;
+  if (__builtin_mul_overflow (a, b, &r))
+    return true;
+  *p = r;
+# else
+  if (b > 0
+     ? (a > INT_MAX / b) || (a < INT_MIN / b)
+     : (b < -1
+        ? (a > INT_MIN / b) || (a < INT_MAX / b)
+        : b == -1 && a == INT_MIN))
+    return true;
+  *p = a * b;
+# endif
+  return false;
+}
+#endif
@@ -0,0 +1,283 @@
+/* Convert ISO 8601 format into seconds since 1970-01-01 00:00 UTC
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "adjusttm.h"
+#include "cmdtmio.h"
+#include "ftsec.h"
+#include "splitlines.h"
+
+extern const char *arg_endptr;
+
+/* Parse the specified argument as the date, time, and UTC offset in
+   ISO 8601 format and set seconds since 1970-01-01 00:00 UTC and
+   nanoseconds less than a second into *SECONDS and *NSEC, which are
+   calculated directly by days elapsed from the date without adjusting
+   by the time zone. Return 1 if set, 0 if not in the format of
+   "YYYY-MM-DDThh:mm:ss[.nnnnnnnnn]" and "Z", "+hhmm", or "-hhmm",
+   otherwise, -1 if a value is outside the range of its parameter.  */
+
+int
+iso8601sec (const char *arg, intmax_t *seconds, int *nsec)
+{
+  int year, month, day;
+  int hour, minutes, sec;
+  int ns = -1;
+  long int utcoff;
+  int *dates[] = { &year, &month, &day };
+  int *times[] = { &hour, &minutes, &sec };
+  struct tm_ptrs tm_ptrs =
+    (struct tm_ptrs) { .dates = dates, .times = times,
+                       .ns = &ns, .utcoff = &utcoff };
+  char *endptr;
+  int set_num = argtmiso8601 (arg, &tm_ptrs, &endptr);
+
+  /* Accept only the date and time followed by the UTC offset, for which
+     the end pointer is replaced with ARG_ENDPTR. */
+  if (set_num <= 0)
+    return set_num;
+  else if (set_num != (ns >= 0 ? 8 : 7) || endptr != arg_endptr)
+    return 0;
+
+  /* Check each value in the range without normalization except for
+     24:00:00 and a leap second, which is carried up simply. */
+  if (month < 1 || month > 12 || day < 1
+      || day > YEAR_DAYS (year, month) - YEAR_DAYS (year, month - 1)
+      || hour > 24 || minutes > 59 || sec > 60
+      || (hour == 24 && (minutes > 0 || sec > 0 || ns > 0)))
+    return -1;
+
+  intmax_t days = EPOCH_DAYS (year, YEAR_DAYS (year, month - 1) + day - 1);
+  intmax_t secs = days * SECONDS_IN_DAY + SECONDS_AT (hour, minutes, sec)
+                  - utcoff;
+
+  if (ns < 0)
+    ns = 0;
+
+  if (secoverflow (secs, ns))
+    return -1;
+
+  *seconds = secs;
+  *nsec = ns;
+
+  return 1;
+}
+
+/* Convert the first field of a line from ISO 8601 format into the record
+   at INDEX in the array of struct secrec pointed to by ARG.  */
+
+static void
+iso8601rec (char *field, char *rest, size_t index, void *arg)
+{
+  struct secrec *rec = (struct secrec *) arg + index;
+
+  if (iso8601sec (field, &rec->seconds, &rec->nsec) <= 0)
+    rec->nsec = -1;
+}
+
+/* Convert the first field of lines, separated by a space or tab, in BUF
+   of SIZE bytes from ISO 8601 format into records of seconds since
+   1970-01-01 00:00 UTC and nanoseconds less than a second as with
+   iso8601sec function, and set those values into RECS up to REC_NUM.
+   The field and newline of converted lines are terminated by the null
+   character in BUF. Store the pointer to the line not converted because
+   its newline is not included in BUF or RECS is filled into *ENDPTR.
+   Return the number of converted lines.  */
+
+size_t
+iso8601secs (char *buf, size_t size,
+             struct secrec *recs, size_t rec_num, char **endptr)
+{
+  return splitlines (buf, size, " \t\r", rec_num, iso8601rec, recs, endptr);
+}
+
+#ifdef TEST
+# include <errno.h>
+# include <stdio.h>
+# include <unistd.h>
+
+# include "error.h"
+# include "exit.h"
+
+char *program_name = "iso8601sec";
+
+static void
+usage (int status)
+{
+  printusage ("iso8601sec", " [FILE]...\n\
+Display seconds since 1970-01-01 00:00 UTC for the first field of each\n\
+line in FILE, or standard input if no FILE, which is the date and time\n\
+in ISO 8601 format with UTC offset. Display \"-\" if not converted.\n\
+\n\
+Options:\n\
+  -q   convert lines but don't display those results",
+true, false, 0);
+  exit (status);
+}
+
+/* The size of buffer into which lines are read  */
+# define ISO8601_BUFSIZE 65536
+
+/* The number of records converted from lines at once  */
+# define SECREC_NUM 1024
+
+static char buf[ISO8601_BUFSIZE + 1];
+static struct secrec recs[SECREC_NUM];
+
+/* Output the specified records to standard output unless QUIET is true.
+   Return true if all records are converted, otherwise, false.  */
+static bool
+printsecrecs (const struct secrec *recs, size_t rec_num, bool quiet)
+{
+  bool success = true;
+  size_t i;
+
+  for (i = 0; i < rec_num; i++)
+    {
+      if (recs[i].nsec < 0)
+        {
+          if (! quiet)
+            fputs ("-\n", stdout);
+          success = false;
+        }
+      else if (! quiet)
+        printelapse (false, recs[i].seconds, recs[i].nsec);
+    }
+
+  return success;
+}
+
+/* Convert all lines read from STREAM. Return true if successfull,
+   otherwise, false.  */
+static bool
+iso8601stream (FILE *stream, bool quiet)
+{
+  size_t size = 0;
+  bool success = true;
+  bool line_skipped = false;
+  bool eof = false;
+
+  while (! eof)
+    {
+      size_t read_size = fread (buf + size, 1, ISO8601_BUFSIZE - size,
+                                stream);
+      char *p = buf;
+      char *endp;
+      size_t rec_num;
+
+      if (read_size == 0)
+        {
+          if (ferror (stream))
+            return false;
+
+          /* Convert the last line not terminated by a newline. */
+          eof = true;
+          if (size == 0)
+            break;
+          buf[size++] = '\n';
+        }
+      else
+        size += read_size;
+
+      /* Skip the rest of a line longer than the buffer. */
+      if (line_skipped)
+        {
+          char *eol = memchr (buf, '\n', size);
+          if (! eol)
+            {
+              size = 0;
+              continue;
+            }
+
+          p = eol + 1;
+          line_skipped = false;
+        }
+
+      while ((rec_num = iso8601secs (p, size - (p - buf),
+                                     recs, SECREC_NUM, &endp)) > 0)
+        {
+          success &= printsecrecs (recs, rec_num, quiet);
+          p = endp;
+        }
+
+      /* Move the line not converted to the head of buffer, or output it
+         as not converted if filling the buffer. */
+      size -= p - buf;
+      if (size >= ISO8601_BUFSIZE)
+        {
+          static const struct secrec long_rec = { 0, -1 };
+
+          printsecrecs (&long_rec, 1, quiet);
+          success = false;
+          line_skipped = true;
+          size = 0;
+        }
+      else
+        memmove (buf, p, size);
+    }
+
+  return success;
+}
+
+int
+main (int argc, char **argv)
+{
+  bool quiet = false;
+  bool success = true;
+  int c;
+
+  while ((c = getopt (argc, argv, ":q")) != -1)
+    {
+      switch (c)
+        {
+        case 'q':
+          quiet = true;
+          break;
+        default:
+          usage (EXIT_FAILURE);
+        }
+    }
+
+  argc -= optind;
+  argv += optind;
+
+  if (argc <= 0)
+    success = iso8601stream (stdin, quiet);
+  else
+    {
+      do
+        {
+          FILE *stream = fopen (*argv, "rb");
+          if (! stream)
+            error (EXIT_FAILURE, errno, "failed to open '%s'", *argv);
+
+          success &= iso8601stream (stream, quiet);
+          fclose (stream);
+          argv++;
+        }
+      while (--argc > 0);
+    }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
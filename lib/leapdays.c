@@ -15,22 +15,22 @@
    along with this program; if not, write to the Free Software Foundation,
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
 
-#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "adjusttm.h"
-#include "intoverflow.h"
 
 #ifdef TEST
+# include <inttypes.h>
 # include <stdio.h>
 
 /* The flag whether the table of leap days is output  */
 static bool table_output = false;
 
 /* The format to output the number of a year or leap days, and spaces  */
-static char year_format[10] = "  %4d  |";
-static char spaces_format[10] = "  %4s  |";
-static char ldays_format[11] = "  %4d day";
+static char year_format[16] = "  %4" PRId64 "  |";
+static char spaces_format[16] = "  %4s  |";
+static char ldays_format[16] = "  %4" PRId64 " day";
 
 /* The length of lines separating a year, duration, and leap days  */
 static int line_lengths[3] = { 6, 6, 11 };
@@ -58,7 +58,7 @@ printline ()
 
 /* Output the number of the specified year in a table.   */
 static void
-printyear (int year, int ydiv100_mark)
+printyear (int64_t year, int ydiv100_mark)
 {
   printf (year_format, year);
   printf (spaces_format, "");
@@ -70,9 +70,9 @@ printyear (int year, int ydiv100_mark)
 
 /* Output a table of leap days from the secified start to end year.  */
 static void
-printtable (int ystart, int yend, int ldays)
+printtable (int64_t ystart, int64_t yend, int64_t ldays)
 {
-  int yterm = yend - ystart;
+  int64_t yterm = yend - ystart;
   if (yterm >= 0)
     {
       printline ();
@@ -136,18 +136,16 @@ printtable (int ystart, int yend, int ldays)
   (((year % div + (div - 1)) % div + (term)) >= div)
 
 /* Calculate the number of leap days included in a duration between
-   the specified two years. If TO_YEAR is more or less than FROM_YEAR,
-   return the positive or negateive value, otherwise, if a leap day is
-   included in TO_YEAR same as FROM_YEAR or not, return 1 or 0.  */
+   the specified two years in 64 bits as with leapdays function.  */
 
-int
-leapdays (int from_year, int to_year)
+int64_t
+leapdays64 (int64_t from_year, int64_t to_year)
 {
-  int ldays = 0;
-  int ystart = from_year;
-  int yend = to_year;
-  int yterm = 0;
-  int delta = 0;
+  int64_t ldays = 0;
+  int64_t ystart = from_year;
+  int64_t yend = to_year;
+  int64_t yterm;
+  int64_t delta = 0;
 
   if (from_year > to_year)
     {
@@ -156,27 +154,21 @@ leapdays (int from_year, int to_year)
     }
 
 #ifdef TEST
-  int yend0 = yend;
+  int64_t yend0 = yend;
 #endif
 
-  /* Calculate the duration bertween two years including themselves. */
-
-  if (INT_SUBTRACT_WRAPV (yend, ystart, &yterm) || yterm)
+  /* Calculate the duration bertween two years including themselves, which
+     never overflows for years in the range of FILETIME and time_t. */
+  yterm = yend - ystart;
+  if (yterm)
     {
       /* Count the number of 400 years into DELTA from start to end year
          and calculate the multiple of 97 leap days in its duration. */
-      if (yterm)
-        {
-          INT_ADD_WRAPV (yterm, 1, &yterm);  /* Ignore the overflow */
-          delta = yterm / 400;
-        }
-      else
-        delta = yend / 400 - ystart / 400
-                + ((yend % 400 - ystart % 400) / 400 ? 1 : 0);
-
+      yterm++;
+      delta = yterm / 400;
       if (delta)
         {
-          int yend_u400 = yend - delta * 400;
+          int64_t yend_u400 = yend - delta * 400;
           ldays = delta * 97;
 
 #ifdef TEST
@@ -192,16 +184,10 @@ leapdays (int from_year, int to_year)
          400 years from end year, not including a year divisible by 400. */
       if (yterm)
         {
-          int yend_next_mod400;  /* Minus value to back a duration */
-          if (yend < INT_MAX)
-            {
-              int yend_next = yend + 1;
-              yend_next_mod400 = yend_next % 400;
-              if (yend_next > 0 && yend_next_mod400 != 0)
-                yend_next_mod400 -= 400;
-            }
-          else
-            yend_next_mod400 = INT_MIN % 400;
+          int64_t yend_next = yend + 1;
+          int yend_next_mod400 = yend_next % 400;  /* Minus value to back */
+          if (yend_next > 0 && yend_next_mod400 != 0)
+            yend_next_mod400 -= 400;
 
           int ydiv100s = (yend_next_mod400 % 100 - yterm) / -100;
           if (ydiv100s)
@@ -226,7 +212,7 @@ leapdays (int from_year, int to_year)
           delta = yterm / 4;
           if (delta)
             {
-              int yend_u4 = yend - delta * 4;
+              int64_t yend_u4 = yend - delta * 4;
               ldays += delta;
 
 #ifdef TEST
@@ -264,8 +250,18 @@ leapdays (int from_year, int to_year)
   return from_year <= to_year ? ldays : - ldays;
 }
 
+/* Calculate the number of leap days included in a duration between
+   the specified two years. If TO_YEAR is more or less than FROM_YEAR,
+   return the positive or negateive value, otherwise, if a leap day is
+   included in TO_YEAR same as FROM_YEAR or not, return 1 or 0.  */
+
+int
+leapdays (int from_year, int to_year)
+{
+  return leapdays64 (from_year, to_year);
+}
+
 #ifdef TEST
-# include <stdint.h>
 # include <unistd.h>
 
 # include "argempty.h"
@@ -291,7 +287,7 @@ Options:\n\
 }
 
 static int
-yearwidth (int year)
+yearwidth (int64_t year)
 {
   int width = 0;
   if (year < 0)
@@ -349,10 +345,7 @@ main (int argc, char **argv)
       char ldays_spaces_format[7] = "  %9s";
       int ystart = years[0] <= years[1] ? years[0] : years[1];
       int yend = years[0] <= years[1] ? years[1] : years[0];
-      int yterm = INT_MAX;
-
-      if (! INT_SUBTRACT_WRAPV (yend, ystart, &yterm))
-        INT_ADD_WRAPV (yterm, 1, &yterm);
+      int64_t yterm = (int64_t) yend - ystart + 1;
 
       int ystart_width = yearwidth (ystart);
       int yend_width = yearwidth (yend);
@@ -366,9 +359,9 @@ main (int argc, char **argv)
         {
           /* Set the output width of a year or leap days in the format to
              the greater width of the specified two years or its duration. */
-          sprintf (year_format, "  %%%dd  |", ywidth);
+          sprintf (year_format, "  %%%d" PRId64 "  |", ywidth);
           sprintf (spaces_format, "  %%%ds  |", ywidth);
-          sprintf (ldays_format, "  %%%dd day", ywidth);
+          sprintf (ldays_format, "  %%%d" PRId64 " day", ywidth);
           sprintf (ldays_spaces_format, "  %%%ds", ywidth + 5);
 
           line_lengths[0] = line_lengths[1] = ywidth + 2;
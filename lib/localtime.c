@@ -32,12 +32,12 @@ long int tm_diff (struct tm const *a, struct tm const *b);
 #endif
 
 #include "ftsec.h"
+#include "timeutils.h"
 #include "wintm.h"
 
 #ifdef USE_TM_SELFIMPL
 # include "adjusttm.h"
 # include "adjusttz.h"
-# include "intoverflow.h"
 #endif
 
 /* Convert the specified seconds since 1970-01-01 00:00 UTC to local time
@@ -81,65 +81,47 @@ localtimew (const intmax_t *seconds, TM *tm)
 # endif
 #else  /* USE_TM_SELFIMPL */
   TIME_ZONE_INFORMATION tzinfo;
-  struct dtm date;
+  struct dtm64 date;
   struct lctm lct;
-  int days = *seconds / SECONDS_IN_DAY;
-  int hour = 0;
-  int min = 0;
-  int sec = 0;
+  int64_t days;
+  int64_t seconds_lct;
+  int daysec;
+  int min;
 
   GetTimeZoneInformation (&tzinfo);
 
   date.tm_year = UNIXEPOCH_YEAR - TM_YEAR_BASE;
   date.tm_mon = 0;
-  date.tm_mday = days + 1;
-  date.tm_wday = -1;
-
-  sec = *seconds - days * SECONDS_IN_DAY;
-
-  /* Add minutes (- tzinfo.Bias) by the offset of time zone to parameters
-     of time converted from UTC seconds since Unix epoch and adjust those
-     to the range of correct values. */
-  if (tzinfo.Bias > INT_MAX || tzinfo.Bias < INT_MIN
-      || INT_SUBTRACT_WRAPV (min, tzinfo.Bias, &min)
-      || ! carrytm (&min, &sec, 60) || ! carrytm (&hour, &min, 60)
-      || ! carrytm (&date.tm_mday, &hour, 24) || ! adjustday (&date))
-    return NULL;
+  date.tm_mday = 1;
+  days = adjustday64 (&date);
+
+  /* Add minutes (- tzinfo.Bias) by the offset of time zone to UTC seconds
+     since Unix epoch in 64 bits and adjust parameters of date to the day
+     for its seconds. */
+  seconds_lct = *seconds - (int64_t) tzinfo.Bias * 60;
+  daysec = adjustdaysec (&date, &days, seconds_lct);
+  min = daysec / 60 % 60;
 
   /* Adjust parameters of time for the increase or decrease of minutes by
      the DST offset of time zone to the range of correct values. */
   lct.tm_year = date.tm_year;
-  lct.tm_ysec = date.tm_yday * SECONDS_IN_DAY + SECONDS_AT (hour, min, sec);
+  lct.tm_ysec = date.tm_yday * SECONDS_IN_DAY + daysec;
   lct.tm_min = min;
   lct.tm_isdst = -1;
 
   if (! adjusttz (&lct, -1))
     return NULL;
 
-  if (min ^ lct.tm_min)
-    {
-      int adj_day = 0;
-
-      min = lct.tm_min;
-      if (! carrytm (&hour, &min, 60) || ! carrytm (&adj_day, &hour, 24))
-        return NULL;
-
-      if (adj_day)
-        {
-          if (INT_ADD_WRAPV (date.tm_mday, adj_day, &date.tm_mday)
-              || ! adjustday (&date))
-            return NULL;
-
-          date.tm_wday = WEEKDAY_FROM (date.tm_wday, adj_day);
-        }
-    }
+  if (lct.tm_min != min)
+    daysec = adjustdaysec (&date, &days,
+                           seconds_lct + (lct.tm_min - min) * 60);
 
   tm->tm_year = date.tm_year;
   tm->tm_mon = date.tm_mon;
   tm->tm_mday = date.tm_mday;
-  tm->tm_hour = hour;
-  tm->tm_min = min;
-  tm->tm_sec = sec;
+  tm->tm_hour = daysec / 3600;
+  tm->tm_min = daysec / 60 % 60;
+  tm->tm_sec = daysec % 60;
   tm->tm_wday = date.tm_wday;
   tm->tm_yday = date.tm_yday;
   tm->tm_isdst = lct.tm_isdst;
@@ -150,6 +132,7 @@ localtimew (const intmax_t *seconds, TM *tm)
 }
 
 #ifdef TEST
+# include <errno.h>
 # include <unistd.h>
 
 # include "argempty.h"
@@ -175,7 +158,9 @@ Options:\n\
   -w   output time with week day name\n\
   -W   output time with week number and day\n\
   -Y   output time with year day\n\
-  -z   output time with time zone\
+  -z   output time with time zone\n\
+  -Z ZONE   convert in the time zone of ZONE instead of local time zone,\n\
+            which is the name of TZif file or POSIX TZ string\
 ", true, false, 0);
   exit (status);
 }
@@ -193,8 +178,9 @@ main (int argc, char **argv)
   bool isdst_output = false;
   struct tm_fmt tm_fmt = { false };
   struct tm_ptrs tm_ptrs = (struct tm_ptrs) { .dates = dates, .times = times };
+  TZ_HANDLE *tz = NULL;
 
-  while ((c = getopt (argc, argv, ":adIJwWYz")) != -1)
+  while ((c = getopt (argc, argv, ":adIJwWYzZ:")) != -1)
     {
       switch (c)
         {
@@ -225,6 +211,11 @@ main (int argc, char **argv)
         case 'z':
           tm_ptrs.utcoff = &tm.tm_gmtoff;
           break;
+        case 'Z':
+          tz = tz_open (optarg);
+          if (! tz)
+            error (EXIT_FAILURE, errno, "invalid time zone '%s'", optarg);
+          break;
         default:
           usage (EXIT_FAILURE);
         }
@@ -243,7 +234,7 @@ main (int argc, char **argv)
   else if (set_num == 0 || ! argempty (endptr))
     usage (EXIT_FAILURE);
 
-  if (localtimew (&seconds, &tm))
+  if (tz ? localtimew_z (tz, &seconds, &tm) : localtimew (&seconds, &tm))
     {
       if (set_num >= 2)
         tm_ptrs.ns = &nsec;
@@ -31,24 +31,13 @@ long int tm_diff (struct tm const *a, struct tm const *b);
 # endif
 #endif
 
+#include "timeutils.h"
 #include "wintm.h"
 
 #ifdef USE_TM_SELFIMPL
 # include "adjusttm.h"
 # include "adjusttz.h"
 # include "ftsec.h"
-# include "imaxoverflow.h"
-# include "intoverflow.h"
-#endif
-
-/* If DST is in effect or not for a time that is either skipped over or
-   repeated when a transition to or from DST occurs, specify a positive
-   value or zero, otherwise, attempt to determine whether the specified
-   time is included in the term of DST  */
-#ifdef TEST
-static int trans_isdst = 1;
-#else
-extern int trans_isdst;
 #endif
 
 /* Convert the specified parameters of time into seconds since 1970-01-01
@@ -59,6 +48,19 @@ extern int trans_isdst;
 
 intmax_t
 mktimew (TM *tm)
+{
+  return mktimewtrans (tm, 1);
+}
+
+/* Convert the specified parameters of time into seconds since 1970-01-01
+   00:00 UTC, as with mktimew function. If DST is in effect or not for a
+   time that is either skipped over or repeated when a transition to or
+   from DST occurs, specify a positive value or zero into TRANS_ISDST,
+   otherwise, attempt to determine whether the time is included in the
+   term of DST, which is available only for the own implementation.  */
+
+intmax_t
+mktimewtrans (TM *tm, int trans_isdst)
 {
 #ifndef USE_TM_SELFIMPL
 # ifdef USE_TM_GLIBC
@@ -97,103 +99,58 @@ mktimew (TM *tm)
   return t;
 # endif
 #else  /* USE_TM_SELFIMPL */
-  struct dtm date;
-  intmax_t seconds;
-  intmax_t epochday;
-  int epochyears;
-  int year;
-  int hour = tm->tm_hour;
-  int min = tm->tm_min;
-  int sec = tm->tm_sec;
+  struct dtm64 date;
+  struct lctm lct;
+  int64_t days;
+  int64_t seconds;
+  int daysec;
+  int min;
 
   date.tm_year = tm->tm_year;
   date.tm_mon = tm->tm_mon;
   date.tm_mday = tm->tm_mday;
-  date.tm_wday = 0; /* No calculation of the week day */
 
-  /* Adjust parameters of date and time to the range of correct values. */
-  if (! carrytm (&min, &sec, 60) || ! carrytm (&hour, &min, 60)
-      || ! carrytm (&date.tm_mday, &hour, 24) || ! adjustday (&date))
+  /* Convert parameters of date and time into seconds since Unix epoch in
+     64 bits, which never overflow for any value of members in *TM, and
+     check whether its value is in the range of time_t at once. */
+  days = adjustday64 (&date);
+  seconds = days * SECONDS_IN_DAY + SECONDS_AT ((int64_t) tm->tm_hour,
+                                                (int64_t) tm->tm_min,
+                                                tm->tm_sec);
+  if (secoverflow (seconds, 0))
     return -1;
 
-  if (INT_ADD_WRAPV (date.tm_year, TM_YEAR_BASE, &year)
-      || INT_SUBTRACT_WRAPV (year, UNIXEPOCH_YEAR, &epochyears))
-    return -1;
-
-  /* Calcuate the day number since Unix epoch including some leap days
-     and set the week day to the remainder of dividing its value by 7. */
-  int ldays = 0;
-
-  if (year ^ UNIXEPOCH_YEAR)
-    {
-      int from_year = UNIXEPOCH_YEAR;
-      int to_year = year;
-      if (year > UNIXEPOCH_YEAR)
-        to_year--;
-      else
-        from_year--;
-
-      ldays = leapdays (from_year, to_year);
-    }
-
-  if (IMAX_MULTIPLY_WRAPV (epochyears, DAYS_IN_YEAR, &epochday)
-      || (ldays && IMAX_ADD_WRAPV (epochday, ldays, &epochday))
-      || IMAX_ADD_WRAPV (epochday, date.tm_yday, &epochday))
-    return -1;
-
-  date.tm_wday = WEEKDAY_FROM (UNIXEPOCH_WEEKDAY, epochday);
-
-  /* Add the number of seconds converted from time in a day to Unix seconds. */
-  if (IMAX_MULTIPLY_WRAPV (epochday, SECONDS_IN_DAY, &seconds)
-      || IMAX_ADD_WRAPV (seconds, SECONDS_AT (hour, min, sec), &seconds)
-      || secoverflow (seconds, 0))
-    return -1;
+  /* Adjust parameters of date to the day for its seconds. */
+  daysec = adjustdaysec (&date, &days, seconds);
+  min = daysec / 60 % 60;
 
   /* Adjust parameters of time for the increase or decrease of minutes by
      the offset of time zone to the range of correct values. */
-  struct lctm lct;
-  intmax_t lct_offset = 0;
-
   lct.tm_year = date.tm_year;
-  lct.tm_ysec = date.tm_yday * SECONDS_IN_DAY + SECONDS_AT (hour, min, sec);
+  lct.tm_ysec = date.tm_yday * SECONDS_IN_DAY + daysec;
   lct.tm_min = min;
   lct.tm_isdst = tm->tm_isdst;
 
   if (! adjusttz (&lct, trans_isdst))
     return -1;
 
-  int adj_min = lct.tm_min - min;
-  if (adj_min)
+  if (lct.tm_min != min)
     {
-      int adj_day = 0;
-
-      min = lct.tm_min;
-      if (IMAX_MULTIPLY_WRAPV (adj_min, 60, &lct_offset)
-          || ! carrytm (&hour, &min, 60) || ! carrytm (&adj_day, &hour, 24))
-        return -1;
-
-      if (adj_day)
-        {
-          if (INT_ADD_WRAPV (date.tm_mday, adj_day, &date.tm_mday)
-              || ! adjustday (&date))
-            return -1;
-
-          date.tm_wday = WEEKDAY_FROM (date.tm_wday, adj_day);
-        }
+      seconds += (lct.tm_min - min) * 60;
+      daysec = adjustdaysec (&date, &days, seconds);
     }
 
   /* Subtract the offset of time zone from UTC seconds since Unix epoch. */
-  if (IMAX_SUBTRACT_WRAPV (lct_offset, lct.tm_gmtoff, &lct_offset)
-      || (lct_offset && (IMAX_ADD_WRAPV (seconds, lct_offset, &seconds)
-                     || secoverflow (seconds, 0))))
+  seconds -= lct.tm_gmtoff;
+  if (secoverflow (seconds, 0))
     return -1;
 
   tm->tm_year = date.tm_year;
   tm->tm_mon = date.tm_mon;
   tm->tm_mday = date.tm_mday;
-  tm->tm_hour = hour;
-  tm->tm_min = min;
-  tm->tm_sec = sec;
+  tm->tm_hour = daysec / 3600;
+  tm->tm_min = daysec / 60 % 60;
+  tm->tm_sec = daysec % 60;
   tm->tm_wday = date.tm_wday;
   tm->tm_yday = date.tm_yday;
   tm->tm_isdst = lct.tm_isdst;
@@ -204,6 +161,7 @@ mktimew (TM *tm)
 }
 
 #ifdef TEST
+# include <errno.h>
 # include <stdio.h>
 # include <unistd.h>
 
@@ -235,6 +193,8 @@ Options:\n\
   -W   output time with week number and day\n\
   -Y   output time with year day\n\
   -z   output time with time zone\n\
+  -Z ZONE   convert in the time zone of ZONE instead of local time zone,\n\
+            which is the name of TZif file or POSIX TZ string\n\
 ", stdout);
   exit (status);
 }
@@ -252,8 +212,10 @@ main (int argc, char **argv)
   bool isdst_output = false;
   struct tm_fmt tm_fmt = { false };
   struct tm_ptrs tm_ptrs = (struct tm_ptrs) { .dates = dates, .times = times };
+  int trans_isdst = 1;
+  TZ_HANDLE *tz = NULL;
 
-  while ((c = getopt (argc, argv, ":adIJswWYzT")) != -1)
+  while ((c = getopt (argc, argv, ":adIJswWYzZ:T")) != -1)
     {
       switch (c)
         {
@@ -287,6 +249,11 @@ main (int argc, char **argv)
         case 'z':
           tm_ptrs.utcoff = &tm.tm_gmtoff;
           break;
+        case 'Z':
+          tz = tz_open (optarg);
+          if (! tz)
+            error (EXIT_FAILURE, errno, "invalid time zone '%s'", optarg);
+          break;
 # ifdef USE_TM_SELFIMPL
         case 'T':
           trans_isdst = 0;
@@ -323,7 +290,7 @@ main (int argc, char **argv)
 
   tm.tm_year -= TM_YEAR_BASE;
 
-  seconds = mktimew (&tm);
+  seconds = tz ? mktimew_z (tz, &tm) : mktimewtrans (&tm, trans_isdst);
 
   if (tm.tm_wday >= 0)
     {
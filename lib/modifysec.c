@@ -38,7 +38,9 @@ currentns ()
   FT ft;
   int ns = FT_NSEC_PRECISION;
 
-  if (currentft (&ft))
+  /* Always get precise time even if the clock of current time is frozen
+     because the value is used as the seed or the permutation key. */
+  if (currentftclock (&ft, FT_CLOCK_PRECISE))
     {
 #ifdef USE_TM_GLIBC
       ns = GET_FT_NSEC (&ft);
@@ -54,27 +56,85 @@ currentns ()
   return ns;
 }
 
+/* Return the next pseudo-random value in *STATE, which is generated by
+   the linear congruential method of rand in MSVCRT, or the additive
+   feedback method of rand in GNU C Library.  */
+static int
+randr (FT_RANDSTATE *state)
+{
 #if defined _WIN32 || defined __CYGWIN__
-/* This bit complements the random value from 30240 to 32767 because its
-   value can only permute half digits as the permutation key  */
-static int permutation_complement_bit = 0;
+  state->value = state->value * 214013 + 2531011;
+
+  return (state->value >> 16) & 0x7fff;
+#else
+  unsigned int value;
+
+  value = state->table[state->front] += state->table[state->rear];
+  if (++state->front >= FT_RANDSTATE_SIZE)
+    {
+      state->front = 0;
+      state->rear++;
+    }
+  else if (++state->rear >= FT_RANDSTATE_SIZE)
+    state->rear = 0;
+
+  return value >> 1;
 #endif
+}
+
+/* The state of pseudo-random values used by modifysec function, which
+   is shared by a process  */
+static FT_RANDSTATE randsec_state;
+static bool randsec_seeded = false;
 
 /* Generate a new sequence of pseudo-random values for the specified seed
-   number in the modification of nanoseconds less than a second. If SEED
-   is less than 0, use current time instead.  */
+   number into *STATE, as with srandsec function.  */
 
 void
-srandsec (int seed)
+srandsecr (FT_RANDSTATE *state, int seed)
 {
   if (seed < 0)
     seed = currentns ();
 
 #if defined _WIN32 || defined __CYGWIN__
-  permutation_complement_bit = seed % 2;
+  /* This bit complements the random value from 30240 to 32767 because its
+     value can only permute half digits as the permutation key. */
+  state->complement_bit = seed % 2;
+  state->value = seed;
+#else
+  /* Initialize the table by the seed and discard values generated first
+     as with srandom_r in GNU C Library. */
+  int word = seed != 0 ? seed : 1;
+  int i;
+
+  state->table[0] = word;
+  for (i = 1; i < FT_RANDSTATE_SIZE; i++)
+    {
+      long int hi = word / 127773;
+      long int lo = word % 127773;
+      word = 16807 * lo - 2836 * hi;
+      if (word < 0)
+        word += 2147483647;
+      state->table[i] = word;
+    }
+
+  state->front = 3;
+  state->rear = 0;
+
+  for (i = 0; i < FT_RANDSTATE_SIZE * 10; i++)
+    randr (state);
 #endif
+}
 
-  srand (seed);
+/* Generate a new sequence of pseudo-random values for the specified seed
+   number in the modification of nanoseconds less than a second. If SEED
+   is less than 0, use current time instead.  */
+
+void
+srandsec (int seed)
+{
+  srandsecr (&randsec_state, seed);
+  randsec_seeded = true;
 }
 
 #if defined _WIN32 || defined __CYGWIN__
@@ -92,14 +152,14 @@ srandsec (int seed)
 
 /* Return the random value of nanoseconds less than a second.  */
 static int
-randns ()
+randns (FT_RANDSTATE *state)
 {
   int rand_ns = 0;
   int rand_rest = 0;
   int i;
   for (i = 0; i < 2; i++)
     {
-      int rand_val = rand ();
+      int rand_val = randr (state);
       int r = rand_val % (RAND_USE_MAX + 1);
       int j;
       for (j = 0; j < RAND_USE_DIGIT_SIZE; j++)
@@ -119,9 +179,10 @@ randns ()
 }
 
 /* Return the value into which digits of the specified nanoseconds less
-   than a second are permuted.  */
+   than a second are permuted by the key generated by *STATE, or current
+   time if STATE is NULL.  */
 static int
-permutens (int nsec, bool random)
+permutens (int nsec, FT_RANDSTATE *state)
 {
   int ns = 0;
   int ns_digits[FT_NSEC_DIGITS] = { 0 };
@@ -140,16 +201,16 @@ permutens (int nsec, bool random)
       720, 120, 24, 6, 2, 1
     };
   int permutation_key;
-  if (random)
+  if (state)
     {
 #if defined _WIN32 || defined __CYGWIN__
-      int r = rand () % (RAND_USE_MAX + 1);
+      int r = randr (state) % (RAND_USE_MAX + 1);
       if (r < 30240)
         permutation_key = r;
       else
-        permutation_key = ((r % 5040) << 1) + permutation_complement_bit;
+        permutation_key = ((r % 5040) << 1) + state->complement_bit;
 #else
-      permutation_key = rand ();
+      permutation_key = randr (state);
 #endif
     }
   else
@@ -198,6 +259,22 @@ permutens (int nsec, bool random)
 
 bool
 modifysec (intmax_t *seconds, int *nsec, int modflag)
+{
+  /* Generate the same sequence as rand function which is not seeded. */
+  if (! randsec_seeded && IS_FT_NSEC_RANDOMIZING (modflag))
+    srandsec (1);
+
+  return modifysecr (seconds, nsec, modflag, &randsec_state);
+}
+
+/* Modify the specified value of seconds since 1970-01-01 00:00 UTC and
+   nanoseconds less than a second, according to MODFLAG, as with modifysec
+   function, but generate pseudo-random values by *STATE. Return true if
+   *NSEC is not less than 0 and modification is performed, otherwise,
+   return false.  */
+
+bool
+modifysecr (intmax_t *seconds, int *nsec, int modflag, FT_RANDSTATE *state)
 {
   if (*nsec >= 0)
     {
@@ -219,10 +296,10 @@ modifysec (intmax_t *seconds, int *nsec, int modflag)
         }
 
       if (ns_random)
-        ns = randns ();
+        ns = randns (state);
 
       if (IS_FT_NSEC_PERMUTE (modflag))
-        ns = permutens (ns, ! ns_random);
+        ns = permutens (ns, ns_random ? NULL : state);
 
       if (ns > 0 && negative)
         ns = FT_NSEC_PRECISION - ns;
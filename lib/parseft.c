@@ -53,6 +53,7 @@
 #include "idx.h"
 #include "imaxoverflow.h"
 #include "intoverflow.h"
+#include "timeutils.h"
 #include "wintm.h"
 
 #ifndef USE_TM_GLIBC
@@ -99,6 +100,9 @@ enum { MERam, MERpm, MER24 };
 /* Maximum length of a time zone name or abbreviation, plus 1.  */
 enum { TIME_ZONE_BUFSIZE = 64 };
 
+/* Number of tokens lexed into the array on the stack at first.  */
+enum { TOKEN_BUFSIZE = 32 };
+
 /* Relative times.  */
 typedef struct
 {
@@ -117,9 +121,22 @@ typedef struct
 /* Information passed to and from the parser.  */
 typedef struct
 {
-  /* The input string remaining to be parsed.  */
+  /* The input string remaining to be lexed.  */
   const char *input;
 
+  /* Tokens lexed from the input string, the last of which is '\0' or '?',
+     and the number of them.  */
+  struct lexed_token *tokens;
+  idx_t token_num;
+
+  /* The index of the token remaining to be parsed.  */
+  idx_t token_index;
+
+#ifdef USE_PARSEFT_MEMO
+  /* Results of sub-parsers memoized for each token, or NULL.  */
+  struct parse_memo *memo;
+#endif
+
   /* N, if this is the Nth Tuesday.  */
   intmax_t day_ordinal;
 
@@ -169,6 +186,11 @@ typedef struct
   /* ANSI codepage of encoding on Windows.  */
   int ansi_cp;
 #endif
+
+#ifdef TEST
+  /* Set true if the state of parsing an expression is output.  */
+  bool parsing_output;
+#endif
 } parser_control;
 
 /* Increment PC->rel by FACTOR * REL (FACTOR is 1 or -1).  Return true
@@ -243,9 +265,25 @@ union YYSTYPE
     int nsec;
   } timespec;
   relative_time rel;
+  struct {
+    textint year;
+    intmax_t month;
+    intmax_t day;
+  } date;
 };
 typedef union YYSTYPE YYSTYPE;
 
+/* A token lexed from the input string.  */
+typedef struct lexed_token
+{
+  /* The input string from which this token is lexed.  */
+  char const *input;
+
+  /* The kind and value of this token.  */
+  int type;
+  YYSTYPE value;
+} lexed_token;
+
 static table const meridian_table[] =
 {
   { "AM",   tMERIDIAN, MERam },
@@ -438,6 +476,29 @@ static table const military_table[] =
   { NULL, 0, 0 }
 };
 
+/* An abbreviation of time zone loaded from TZif files.  */
+typedef struct
+{
+  char name[TIME_ZONE_BUFSIZE];
+  int type;
+  int value;
+} loaded_zone;
+
+/* The index of time zone abbreviations, built by loadtzabbrs before
+   threads are started and shared read-only by all parses.  Entries are
+   hashed by their names into the open addressing table whose size is a
+   power of 2, and the first entry inserted for a name is used in the
+   order of universal, local, and the above table, and those loaded from
+   TZif files.  Local zone abbreviations are probed only once when loaded,
+   instead of for each parse.  */
+static struct
+{
+  table *entries;          /* NULL if not loaded */
+  idx_t mask;              /* The number of entries minus 1 */
+  loaded_zone *loaded;     /* The names loaded from TZif files */
+  char tz_abbr[2][TIME_ZONE_BUFSIZE];
+} zone_index;
+
 
 
 /* Convert a time zone expressed as HH:MM into an integer count of
@@ -511,11 +572,46 @@ to_tm_year (textint textyear, int *tm_year)
   return true;
 }
 
+/* Return the hash value of NAME by FNV-1a.  */
+
+static uint32_t
+hash_zone (char const *name)
+{
+  uint32_t h = 2166136261u;
+
+  for (; *name; name++)
+    h = (h ^ to_uchar (*name)) * 16777619u;
+
+  return h;
+}
+
+/* Return the slot for NAME in the index of time zone abbreviations, which
+   is an empty entry if not found.  */
+
+static table *
+zone_index_slot (char const *name)
+{
+  idx_t i;
+
+  for (i = hash_zone (name) & zone_index.mask; zone_index.entries[i].name;
+       i = (i + 1) & zone_index.mask)
+    if (strcmp (name, zone_index.entries[i].name) == 0)
+      break;
+
+  return zone_index.entries + i;
+}
+
 static table const *
 lookup_zone (parser_control const *pc, char const *name)
 {
   table const *tp;
 
+  if (zone_index.entries)
+    {
+      tp = zone_index_slot (name);
+      return tp->name ? tp : NULL;
+    }
+
   for (tp = universal_time_zone_table; tp->name; tp++)
     if (strcmp (name, tp->name) == 0)
       return tp;
@@ -710,9 +806,12 @@ yylex (YYSTYPE *lvalp, parser_control *pc)
             {
               do
                 {
-                  *p++ = c;
+                  if (maxsize > 1)
+                    {
+                      *p++ = c;
+                      maxsize--;
+                    }
                   c = *++pc->input;
-                  maxsize--;
                 }
               while (isalpha (c) || c == '.');
 
@@ -763,6 +862,72 @@ yylex (YYSTYPE *lvalp, parser_control *pc)
   return 1;
 }
 
+/* Lex the whole input string of *PC into tokens until '\0' or '?' and
+   set those into PC->tokens, which is BUF of BUF_NUM tokens at first and
+   replaced with an array allocated by malloc when filled, so that the
+   parser backtracks by resetting only the index of tokens. Return true
+   if successful, otherwise, false.  */
+static bool
+tokenize (parser_control *pc, lexed_token *buf, idx_t buf_num)
+{
+  idx_t alloc = buf_num;
+  YYSTYPE lval = { 0 };
+  int type;
+
+  pc->tokens = buf;
+  pc->token_num = 0;
+  pc->token_index = 0;
+
+  do
+    {
+      if (pc->token_num >= alloc)
+        {
+          lexed_token *tokens;
+          if (alloc > PTRDIFF_MAX / 2 / (idx_t) sizeof *tokens)
+            return false;
+
+          alloc *= 2;
+          if (pc->tokens == buf)
+            {
+              tokens = malloc (sizeof *tokens * alloc);
+              if (tokens)
+                memcpy (tokens, buf, sizeof *tokens * pc->token_num);
+            }
+          else
+            tokens = realloc (pc->tokens, sizeof *tokens * alloc);
+          if (! tokens)
+            return false;
+
+          pc->tokens = tokens;
+        }
+
+      /* The value of a token which has no value is left as the previous
+         value, in the same way as calling yylex repeatedly.  */
+      lexed_token *tp = pc->tokens + pc->token_num++;
+      tp->input = pc->input;
+      type = yylex (&lval, pc);
+      tp->type = type;
+      tp->value = lval;
+    }
+  while (type != '\0' && type != '?');
+
+  return true;
+}
+
+/* Set the value of the next token in *PC into *LVALP and return its type.
+   The last token, '\0' or '?', is returned repeatedly.  */
+static int
+next_token (YYSTYPE *lvalp, parser_control *pc)
+{
+  lexed_token const *tp = pc->tokens + pc->token_index;
+
+  if (pc->token_index < pc->token_num - 1)
+    pc->token_index++;
+
+  *lvalp = tp->value;
+  return tp->type;
+}
+
 /* States of parsing an expression.  */
 enum
 {
@@ -773,9 +938,6 @@ enum
 };
 
 #ifdef TEST
-/* Set true if the state of parsing an expression is output.  */
-static bool parsing_output = false;
-
 static char const *parsing_states[] = { "Start", "Accept", "Abort", "Stop" };
 
 /* Output the specified state of parsing an expression.  */
@@ -837,14 +999,17 @@ print_parsing_relunit_state (int state, char const *symbol,
   return 1;
 }
 
-/* Output the state of parsing an expression.  */
+/* Output the state of parsing an expression if the parsing_output member
+   is true in the parser_control of the function, pointed to by PC.  */
 # define PARSING_EXPR(state,symbol,expr) \
-           (parsing_output ? print_parsing_state (state, 0, symbol, expr) : 0)
+           (pc->parsing_output \
+            ? print_parsing_state (state, 0, symbol, expr) : 0)
 # define PARSING_RELUNIT(state,symbol,num_token,relunit_token) \
-           (parsing_output \
+           (pc->parsing_output \
             ? print_parsing_relunit_state ( \
                 state, symbol, num_token, relunit_token) : 0)
-# define PARSING_START(symbol,expr)  PARSING_EXPR (STATE_START, symbol, expr)
+# define PARSING_START(symbol,pc,index) \
+           PARSING_EXPR (STATE_START, symbol, (pc)->tokens[index].input)
 # define PARSING_ACCEPT(symbol,expr) PARSING_EXPR (STATE_ACCEPT, symbol, expr)
 # define PARSING_ACCEPT_RELUNIT(symbol,num_token,relunit_token) \
            PARSING_RELUNIT (STATE_ACCEPT, symbol, num_token, relunit_token)
@@ -857,7 +1022,7 @@ print_parsing_relunit_state (int state, char const *symbol,
            PARSING_RELUNIT (STATE_ABORT, symbol, num_token, -1)
 # define PARSING_STOP(symbol)        PARSING_EXPR (STATE_STOP, symbol, NULL)
 #else
-# define PARSING_START(symbol,expr)
+# define PARSING_START(symbol,pc,index)
 # define PARSING_ACCEPT(symbol,expr)
 # define PARSING_ACCEPT_RELUNIT(symbol,num_token,relunit_token)
 # define PARSING_ACCEPT_NUMBER(symbol,num_token)
@@ -867,10 +1032,70 @@ print_parsing_relunit_state (int state, char const *symbol,
 # define PARSING_STOP(symbol)
 #endif
 
+#ifdef USE_PARSEFT_MEMO
+/* Sub-parsers whose results are memoized.  */
+enum
+{
+  MEMO_UNSIGNED_SECONDS,
+  MEMO_O_COLON_MINUTES,
+  MEMO_ISO_8601_DATE,
+  MEMO_RELUNIT_SNUMBER,
+  MEMO_RELUNIT,
+  MEMO_RULE_NUM
+};
+
+/* The result of a sub-parser started by a token.  */
+typedef struct parse_memo
+{
+  /* The state returned by the sub-parser, or STATE_START if not parsed.  */
+  int state;
+
+  /* The index of the token following those parsed by the sub-parser.  */
+  idx_t end;
+
+  /* The value set into *LVALP by the sub-parser.  */
+  YYSTYPE value;
+} parse_memo;
+
+/* Parse the leading string by PARSER as RULE unless the result started by
+   the same token is memoized in PC->memo, and memoize it if not NULL, so
+   that each sub-parser runs at most once for a token. PARSER must not
+   change *PC except for the index of tokens.  */
+static int
+memoize (int rule, int (*parser) (YYSTYPE *, parser_control *),
+         YYSTYPE *lvalp, parser_control *pc)
+{
+  if (! pc->memo)
+    return parser (lvalp, pc);
+
+  parse_memo *mp = pc->memo + pc->token_index * MEMO_RULE_NUM + rule;
+  if (mp->state == STATE_START)
+    {
+      mp->state = parser (lvalp, pc);
+      mp->end = pc->token_index;
+      mp->value = *lvalp;
+    }
+  else if (mp->state != STATE_STOP)
+    {
+      /* Leave *LVALP if stopped, which is restored by the sub-parser.  */
+      pc->token_index = mp->end;
+      *lvalp = mp->value;
+    }
+
+  return mp->state;
+}
+
+/* Call the sub-parser memoized as the specified rule.  */
+# define PARSE_MEMO(rule,parser,lvalp,pc) memoize (rule, parser, lvalp, pc)
+#else
+# define PARSE_MEMO(rule,parser,lvalp,pc) parser (lvalp, pc)
+#endif
+
 /* Return true if parsing is stopped for STATE and the next is started, and
    increment *COUNTER if not NULL and the specified expression is accepted.  */
 static inline bool
-next_parsing (int state, char const *symbol, char const *expr, idx_t *counter)
+next_parsing (int state, char const *symbol, char const *expr, idx_t *counter,
+              parser_control *pc)
 {
   switch (state)
     {
@@ -897,13 +1122,13 @@ next_parsing (int state, char const *symbol, char const *expr, idx_t *counter)
 static int
 parse_seconds (YYSTYPE *lvalp, parser_control *pc, bool sign_accepted)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("seconds", p0);
+  PARSING_START ("seconds", pc, i0);
 
   int seconds;
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   switch (token)
     {
     case tSDECIMAL_NUMBER:
@@ -934,13 +1159,21 @@ parse_seconds (YYSTYPE *lvalp, parser_control *pc, bool sign_accepted)
       return STATE_ABORT;
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("seconds");
   return STATE_STOP;
 }
 
+/* Parse the leading string as unsigned_seconds.  */
+
+static int
+parse_unsigned_seconds (YYSTYPE *lvalp, parser_control *pc)
+{
+  return parse_seconds (lvalp, pc, false);
+}
+
 /* Parse the leading string as timespec.
 
    timespec := '@' seconds
@@ -951,12 +1184,12 @@ parse_seconds (YYSTYPE *lvalp, parser_control *pc, bool sign_accepted)
 static int
 parse_timespec (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("timespec", p0);
+  PARSING_START ("timespec", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == '@')
     {
       switch (parse_seconds (lvalp, pc, true))
@@ -973,7 +1206,7 @@ parse_timespec (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("timespec");
@@ -990,14 +1223,14 @@ parse_timespec (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_o_colon_minutes (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
 
-  PARSING_START ("o_colon_minutes", p0);
+  PARSING_START ("o_colon_minutes", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == ':')
     {
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tUNUMBER)  /* ':' tUNUMBER */
         {
           lvalp->intval = lvalp->textintval.value;
@@ -1010,7 +1243,7 @@ parse_o_colon_minutes (YYSTYPE *lvalp, parser_control *pc)
   /* empty */
   lvalp->intval = -1;
 
-  pc->input = p0;
+  pc->token_index = i0;
 
   PARSING_ACCEPT ("o_colon_minutes", "empty");
   return STATE_ACCEPT;
@@ -1019,6 +1252,17 @@ parse_o_colon_minutes (YYSTYPE *lvalp, parser_control *pc)
 static int parse_iso_8601_date (YYSTYPE *lvalp, parser_control *pc);
 static int parse_iso_8601_time (YYSTYPE *lvalp, parser_control *pc);
 
+/* Set PC-> year, month, and day members from the date in *VALP, which is
+   accepted as iso_8601_date.  */
+static void
+set_iso_8601_date (parser_control *pc, YYSTYPE const *valp)
+{
+  pc->year = valp->date.year;
+  pc->month = valp->date.month;
+  pc->day = valp->date.day;
+  pc->year_seen = true;
+}
+
 /* Parse the leading string as iso_8601_datetime.
 
    iso_8601_datetime := iso_8601_date 'T' iso_8601_time
@@ -1029,22 +1273,26 @@ static int parse_iso_8601_time (YYSTYPE *lvalp, parser_control *pc);
 static int
 parse_iso_8601_datetime (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
+  YYSTYPE val1;
   int token;
 
-  PARSING_START ("iso_8601_datetime", p0);
+  PARSING_START ("iso_8601_datetime", pc, i0);
 
-  switch (parse_iso_8601_date (lvalp, pc))
+  switch (PARSE_MEMO (MEMO_ISO_8601_DATE, parse_iso_8601_date, lvalp, pc))
     {
     case STATE_ACCEPT:
-      token = yylex (lvalp, pc);
+      val1 = *lvalp;
+      token = next_token (lvalp, pc);
       if (token == 'T')
         {
           /* iso_8601_date 'T' iso_8601_time */
           int state = parse_iso_8601_time (lvalp, pc);
+          if (state == STATE_ACCEPT)
+            set_iso_8601_date (pc, &val1);
           if (! next_parsing (state, "iso_8601_datetime",
-                              "iso_8601_date 'T' iso_8601_time", NULL))
+                              "iso_8601_date 'T' iso_8601_time", NULL, pc))
             return state;
         }
       break;
@@ -1052,7 +1300,7 @@ parse_iso_8601_datetime (YYSTYPE *lvalp, parser_control *pc)
       return STATE_ABORT;
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("iso_8601_datetime");
@@ -1069,11 +1317,11 @@ parse_iso_8601_datetime (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_datetime (YYSTYPE *lvalp, parser_control *pc)
 {
-  PARSING_START ("datetime", pc->input);
+  PARSING_START ("datetime", pc, pc->token_index);
 
   /* iso_8601_datetime */
   int state = parse_iso_8601_datetime (lvalp, pc);
-  if (! next_parsing (state, "datetime", "iso_8601_datetime", NULL))
+  if (! next_parsing (state, "datetime", "iso_8601_datetime", NULL, pc))
     return state;
 
   PARSING_STOP ("datetime");
@@ -1090,16 +1338,17 @@ parse_datetime (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_zone_offset (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("zone_offset", p0);
+  PARSING_START ("zone_offset", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tSNUMBER)
     {
       YYSTYPE val1 = *lvalp;
-      switch (parse_o_colon_minutes (lvalp, pc))
+      switch (PARSE_MEMO (MEMO_O_COLON_MINUTES,
+                          parse_o_colon_minutes, lvalp, pc))
         {
         case STATE_ACCEPT:
           pc->zones_seen++;
@@ -1116,7 +1365,7 @@ parse_zone_offset (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("zone_offset");
@@ -1133,11 +1382,11 @@ parse_zone_offset (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_o_zone_offset (YYSTYPE *lvalp, parser_control *pc)
 {
-  PARSING_START ("o_zone_offset", pc->input);
+  PARSING_START ("o_zone_offset", pc, pc->token_index);
 
   /* zone_offset */
   int state = parse_zone_offset (lvalp, pc);
-  if (! next_parsing (state, "o_zone_offset", "zone_offset", NULL))
+  if (! next_parsing (state, "o_zone_offset", "zone_offset", NULL, pc))
     return state;
 
   /* empty */
@@ -1158,36 +1407,37 @@ parse_o_zone_offset (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_iso_8601_time (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("iso_8601_time", p0);
+  PARSING_START ("iso_8601_time", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token != tUNUMBER)
     {
-      pc->input = p0;
+      pc->token_index = i0;
       *lvalp = val0;
 
       PARSING_STOP ("iso_8601_time");
       return STATE_STOP;
     }
 
-  char const *p1 = pc->input;
+  idx_t i1 = pc->token_index;
   YYSTYPE val1 = *lvalp;
-  token = yylex (lvalp, pc);
+  token = next_token (lvalp, pc);
   if (token == ':')
     {
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tUNUMBER)
         {
-          char const *p3 = pc->input;
+          idx_t i3 = pc->token_index;
           YYSTYPE val3 = *lvalp;
-          token = yylex (lvalp, pc);
+          token = next_token (lvalp, pc);
           if (token == ':')
             {
               YYSTYPE val5;
-              int state = parse_seconds (lvalp, pc, false);
+              int state = PARSE_MEMO (MEMO_UNSIGNED_SECONDS,
+                                      parse_unsigned_seconds, lvalp, pc);
               if (state == STATE_ACCEPT)
                 {
                   val5 = *lvalp;
@@ -1213,7 +1463,7 @@ parse_iso_8601_time (YYSTYPE *lvalp, parser_control *pc)
             }
           else
             {
-              pc->input = p3;
+              pc->token_index = i3;
               *lvalp = val3;
               switch (parse_o_zone_offset (lvalp, pc))
                 {
@@ -1233,7 +1483,7 @@ parse_iso_8601_time (YYSTYPE *lvalp, parser_control *pc)
     }
   else
     {
-      pc->input = p1;
+      pc->token_index = i1;
       *lvalp = val1;
       switch (parse_zone_offset (lvalp, pc))
         {
@@ -1248,7 +1498,7 @@ parse_iso_8601_time (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("iso_8601_time");
@@ -1268,15 +1518,15 @@ parse_iso_8601_time (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_time (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("time", p0);
+  PARSING_START ("time", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token != tUNUMBER)
     {
-      pc->input = p0;
+      pc->token_index = i0;
       *lvalp = val0;
 
       PARSING_STOP ("time");
@@ -1284,7 +1534,7 @@ parse_time (YYSTYPE *lvalp, parser_control *pc)
     }
 
   YYSTYPE val1 = *lvalp;
-  token = yylex (lvalp, pc);
+  token = next_token (lvalp, pc);
   if (token == tMERIDIAN)  /* tUNUMBER tMERIDIAN */
     {
       set_hhmmss (pc, val1.textintval.value, 0, 0, 0);
@@ -1295,11 +1545,11 @@ parse_time (YYSTYPE *lvalp, parser_control *pc)
     }
   else if (token == ':')
     {
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tUNUMBER)
         {
           YYSTYPE val3 = *lvalp;
-          token = yylex (lvalp, pc);
+          token = next_token (lvalp, pc);
           if (token == tMERIDIAN)  /* tUNUMBER ':' tUNUMBER tMERIDIAN */
             {
               set_hhmmss (
@@ -1312,11 +1562,12 @@ parse_time (YYSTYPE *lvalp, parser_control *pc)
           else if (token == ':')
             {
               YYSTYPE val5;
-              switch (parse_seconds (lvalp, pc, false))
+              switch (PARSE_MEMO (MEMO_UNSIGNED_SECONDS,
+                                  parse_unsigned_seconds, lvalp, pc))
                 {
                 case STATE_ACCEPT:
                   val5 = *lvalp;
-                  token = yylex (lvalp, pc);
+                  token = next_token (lvalp, pc);
                   if (token == tMERIDIAN) /* tUNUMBER ':' tUNUMBER ':'
                                              unsigned_seconds tMERIDIAN */
                     {
@@ -1338,12 +1589,12 @@ parse_time (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   /* iso_8601_time */
   int state = parse_iso_8601_time (lvalp, pc);
-  if (! next_parsing (state, "time", "iso_8601_time", NULL))
+  if (! next_parsing (state, "time", "iso_8601_time", NULL, pc))
     return state;
 
   PARSING_STOP ("time");
@@ -1362,10 +1613,10 @@ parse_time (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_local_zone (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("local_zone", p0);
+  PARSING_START ("local_zone", pc, i0);
 
   /* Local zone strings affect only the DST setting, and take effect
      only if the current TZ setting is relevant.
@@ -1384,16 +1635,16 @@ parse_local_zone (YYSTYPE *lvalp, parser_control *pc)
      the lexical lookup table with type tLOCAL_ZONE.
      (Search for 'quarter' comment in  'parse_datetime2'.)
   */
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tLOCAL_ZONE)
     {
-      char const *p1 = pc->input;
+      idx_t i1 = pc->token_index;
       YYSTYPE val1 = *lvalp;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token != tDST)  /* tLOCAL_ZONE */
         {
           pc->local_isdst = val1.intval;
-          pc->input = p1;
+          pc->token_index = i1;
 
           PARSING_ACCEPT ("local_zone", "tLOCAL_ZONE");
           return STATE_ACCEPT;
@@ -1408,7 +1659,7 @@ parse_local_zone (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("local_zone");
@@ -1433,17 +1684,18 @@ static int parse_relunit_snumber (YYSTYPE *lvalp, parser_control *pc);
 static int
 parse_zone (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("zone", p0);
+  PARSING_START ("zone", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tZONE)
     {
-      char const *p1 = pc->input;
+      idx_t i1 = pc->token_index;
       YYSTYPE val1;
-      switch (parse_relunit_snumber (lvalp, pc))
+      switch (PARSE_MEMO (MEMO_RELUNIT_SNUMBER,
+                          parse_relunit_snumber, lvalp, pc))
         {
         case STATE_ACCEPT:  /* tZONE relunit_snumber */
           pc->time_zone = val1.intval;
@@ -1458,11 +1710,12 @@ parse_zone (YYSTYPE *lvalp, parser_control *pc)
         }
 
       val1 = *lvalp;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tSNUMBER)
         {
           YYSTYPE val2 = *lvalp;
-          switch (parse_o_colon_minutes (lvalp, pc))
+          switch (PARSE_MEMO (MEMO_O_COLON_MINUTES,
+                              parse_o_colon_minutes, lvalp, pc))
             {
             case STATE_ACCEPT:  /* tZONE tSNUMBER o_colon_minutes */
               if (time_zone_hhmm (pc, val2.textintval, lvalp->intval)
@@ -1480,7 +1733,7 @@ parse_zone (YYSTYPE *lvalp, parser_control *pc)
       else if (token != tDST)  /* tZONE */
         {
           pc->time_zone = val1.intval;
-          pc->input = p1;
+          pc->token_index = i1;
 
           PARSING_ACCEPT ("zone", "tZONE");
           return STATE_ACCEPT;
@@ -1499,7 +1752,8 @@ parse_zone (YYSTYPE *lvalp, parser_control *pc)
          8601 date and time of day representation.  */
       pc->time_zone = -HOUR (7);
 
-      switch (parse_relunit_snumber (lvalp, pc))
+      switch (PARSE_MEMO (MEMO_RELUNIT_SNUMBER,
+                          parse_relunit_snumber, lvalp, pc))
         {
         case STATE_ACCEPT:  /* 'T' relunit_snumber */
           if (apply_relative_time (pc, lvalp->rel, 1))
@@ -1525,7 +1779,7 @@ parse_zone (YYSTYPE *lvalp, parser_control *pc)
       return STATE_ACCEPT;
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("zone");
@@ -1545,21 +1799,21 @@ parse_zone (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_day (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("day", p0);
+  PARSING_START ("day", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tDAY)
     {
-      char const *p1 = pc->input;
+      idx_t i1 = pc->token_index;
       pc->day_ordinal = 0;
       pc->day_number = lvalp->intval;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token != ',')  /* tDAY */
         {
-          pc->input = p1;
+          pc->token_index = i1;
 
           PARSING_ACCEPT ("day", "tDAY");
           return STATE_ACCEPT;
@@ -1572,7 +1826,7 @@ parse_day (YYSTYPE *lvalp, parser_control *pc)
   else if (token == tORDINAL)
     {
       YYSTYPE val1 = *lvalp;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tDAY)  /* tORDINAL tDAY */
         {
           pc->day_ordinal = val1.intval;
@@ -1585,7 +1839,7 @@ parse_day (YYSTYPE *lvalp, parser_control *pc)
   else if (token == tUNUMBER)
     {
       YYSTYPE val1 = *lvalp;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tDAY)  /* tUNUMBER tDAY */
         {
           pc->day_ordinal = val1.textintval.value;
@@ -1596,7 +1850,7 @@ parse_day (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("day");
@@ -1607,39 +1861,41 @@ parse_day (YYSTYPE *lvalp, parser_control *pc)
 
    iso_8601_date := tUNUMBER tSNUMBER tSNUMBER
 
-   If accepted as iso_8601_date, return STATE_ACCEPT, or if its value is
-   incorrect, return STATE_ABORT, otherwise, return STATE_STOP.  */
+   If accepted as iso_8601_date, set its date into LVALP->date and return
+   STATE_ACCEPT, or if its value is incorrect, return STATE_ABORT,
+   otherwise, return STATE_STOP.  */
 
 static int
 parse_iso_8601_date (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("iso_8601_date", p0);
+  PARSING_START ("iso_8601_date", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tUNUMBER)
     {
       YYSTYPE val1 = *lvalp;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tSNUMBER)
         {
           YYSTYPE val2 = *lvalp;
-          token = yylex (lvalp, pc);
+          token = next_token (lvalp, pc);
           if (token == tSNUMBER)  /* tUNUMBER tSNUMBER tSNUMBER */
             {
               /* ISO 8601 format.  YYYY-MM-DD.  */
-              pc->year = val1.textintval;
-              if (IMAX_SUBTRACT_WRAPV (0, val2.textintval.value, &pc->month)
-                  || IMAX_SUBTRACT_WRAPV (
-                        0, lvalp->textintval.value, &pc->day))
+              intmax_t month, day;
+              if (IMAX_SUBTRACT_WRAPV (0, val2.textintval.value, &month)
+                  || IMAX_SUBTRACT_WRAPV (0, lvalp->textintval.value, &day))
                 {
                   PARSING_ABORT ("iso_8601_date",
                                  "tUNUMBER tSNUMBER tSNUMBER");
                   return STATE_ABORT;
                 }
-              pc->year_seen = true;
+              lvalp->date.year = val1.textintval;
+              lvalp->date.month = month;
+              lvalp->date.day = day;
 
               PARSING_ACCEPT ("iso_8601_date", "tUNUMBER tSNUMBER tSNUMBER");
               return STATE_ACCEPT;
@@ -1647,7 +1903,7 @@ parse_iso_8601_date (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("iso_8601_date");
@@ -1672,36 +1928,36 @@ parse_iso_8601_date (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_date (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("date", p0);
+  PARSING_START ("date", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tUNUMBER)
     {
       YYSTYPE val1 = *lvalp;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == '/')
         {
-          token = yylex (lvalp, pc);
+          token = next_token (lvalp, pc);
           if (token == tUNUMBER)
             {
-              char const *p3 = pc->input;
+              idx_t i3 = pc->token_index;
               YYSTYPE val3 = *lvalp;
-              token = yylex (lvalp, pc);
+              token = next_token (lvalp, pc);
               if (token != '/')  /* tUNUMBER '/' tUNUMBER */
                 {
                   pc->month = val1.textintval.value;
                   pc->day = val3.textintval.value;
-                  pc->input = p3;
+                  pc->token_index = i3;
 
                   PARSING_ACCEPT ("date", "tUNUMBER '/' tUNUMBER");
                   return STATE_ACCEPT;
                 }
               else
                 {
-                  token = yylex (lvalp, pc);
+                  token = next_token (lvalp, pc);
                   if (token == tUNUMBER)
                     /* tUNUMBER '/' tUNUMBER '/' tUNUMBER */
                     {
@@ -1734,9 +1990,9 @@ parse_date (YYSTYPE *lvalp, parser_control *pc)
         }
       else if (token == tMONTH)
         {
-          char const *p2 = pc->input;
+          idx_t i2 = pc->token_index;
           YYSTYPE val2 = *lvalp;
-          token = yylex (lvalp, pc);
+          token = next_token (lvalp, pc);
           if (token == tSNUMBER)  /* tUNUMBER tMONTH tSNUMBER */
             {
               /* e.g. 17-JUN-1992.  */
@@ -1758,7 +2014,7 @@ parse_date (YYSTYPE *lvalp, parser_control *pc)
             {
               pc->day = val1.textintval.value;
               pc->month = val2.intval;
-              pc->input = p2;
+              pc->token_index = i2;
 
               PARSING_ACCEPT ("date", "tUNUMBER tMONTH");
               return STATE_ACCEPT;
@@ -1778,11 +2034,11 @@ parse_date (YYSTYPE *lvalp, parser_control *pc)
   else if (token == tMONTH)
     {
       YYSTYPE val1 = *lvalp;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tSNUMBER)
         {
           YYSTYPE val2 = *lvalp;
-          token = yylex (lvalp, pc);
+          token = next_token (lvalp, pc);
           if (token == tSNUMBER)  /* tMONTH tSNUMBER tSNUMBER */
             {
               /* e.g. JUN-17-1992.  */
@@ -1803,21 +2059,21 @@ parse_date (YYSTYPE *lvalp, parser_control *pc)
         }
       else if (token == tUNUMBER)
         {
-          char const *p2 = pc->input;
+          idx_t i2 = pc->token_index;
           YYSTYPE val2 = *lvalp;
-          token = yylex (lvalp, pc);
+          token = next_token (lvalp, pc);
           if (token != ',')  /* tMONTH tUNUMBER */
             {
               pc->month = val1.intval;
               pc->day = val2.textintval.value;
-              pc->input = p2;
+              pc->token_index = i2;
 
               PARSING_ACCEPT ("date", "tMONTH tUNUMBER");
               return STATE_ACCEPT;
             }
           else
             {
-              token = yylex (lvalp, pc);
+              token = next_token (lvalp, pc);
               if (token == tUNUMBER)  /* tMONTH tUNUMBER ',' tUNUMBER */
                 {
                   pc->month = val1.intval;
@@ -1832,12 +2088,14 @@ parse_date (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   /* iso_8601_date */
-  int state = parse_iso_8601_date (lvalp, pc);
-  if (! next_parsing (state, "date", "iso_8601_date", NULL))
+  int state = PARSE_MEMO (MEMO_ISO_8601_DATE, parse_iso_8601_date, lvalp, pc);
+  if (state == STATE_ACCEPT)
+    set_iso_8601_date (pc, lvalp);
+  if (! next_parsing (state, "date", "iso_8601_date", NULL, pc))
     return state;
 
   PARSING_STOP ("date");
@@ -1859,15 +2117,15 @@ parse_date (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_relunit_snumber (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("relunit_snumber", p0);
+  PARSING_START ("relunit_snumber", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token != tSNUMBER)
     {
-      pc->input = p0;
+      pc->token_index = i0;
       *lvalp = val0;
 
       PARSING_STOP ("relunit_snumber");
@@ -1876,7 +2134,7 @@ parse_relunit_snumber (YYSTYPE *lvalp, parser_control *pc)
 
   intmax_t num_value = lvalp->textintval.value;
   intmax_t rel_value;
-  int relunit_token = yylex (lvalp, pc);
+  int relunit_token = next_token (lvalp, pc);
   switch (relunit_token)
     {
     case tYEAR_UNIT:  /* tSNUMBER tYEAR_UNIT */
@@ -1909,7 +2167,7 @@ parse_relunit_snumber (YYSTYPE *lvalp, parser_control *pc)
       lvalp->rel.seconds = num_value;
       break;
     default:
-      pc->input = p0;
+      pc->token_index = i0;
       *lvalp = val0;
 
       PARSING_STOP ("relunit_snumber");
@@ -1950,36 +2208,37 @@ parse_relunit_snumber (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_relunit (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
 
-  PARSING_START ("relunit", p0);
+  PARSING_START ("relunit", pc, i0);
   YYSTYPE val0 = *lvalp;
 
   /* relunit_snumber */
-  int state = parse_relunit_snumber (lvalp, pc);
-  if (! next_parsing (state, "relunit", "relunit_snumber", NULL))
+  int state = PARSE_MEMO (MEMO_RELUNIT_SNUMBER,
+                          parse_relunit_snumber, lvalp, pc);
+  if (! next_parsing (state, "relunit", "relunit_snumber", NULL, pc))
     return state;
 
   intmax_t num_value = 1;
   int num_token = -1;
   int relunit_token;
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tORDINAL)
     {
       num_token = token;
       num_value = lvalp->intval;
-      relunit_token = yylex (lvalp, pc);
+      relunit_token = next_token (lvalp, pc);
     }
   else if (token == tUNUMBER)
     {
       num_token = token;
       num_value = lvalp->textintval.value;
-      relunit_token = yylex (lvalp, pc);
+      relunit_token = next_token (lvalp, pc);
     }
   else if (token == tSDECIMAL_NUMBER || token == tUDECIMAL_NUMBER)
     {
       YYSTYPE val1 = *lvalp;
-      relunit_token = yylex (lvalp, pc);
+      relunit_token = next_token (lvalp, pc);
       if (relunit_token == tSEC_UNIT)
         /* [ tSDECIMAL_NUMBER | tUDECIMAL_NUMBER ] tSEC_UNIT */
         {
@@ -1991,7 +2250,7 @@ parse_relunit (YYSTYPE *lvalp, parser_control *pc)
           return STATE_ACCEPT;
         }
 
-      pc->input = p0;
+      pc->token_index = i0;
       *lvalp = val0;
 
       PARSING_STOP ("relunit");
@@ -2033,7 +2292,7 @@ parse_relunit (YYSTYPE *lvalp, parser_control *pc)
       lvalp->rel.seconds = num_value;
       break;
     default:
-      pc->input = p0;
+      pc->token_index = i0;
       *lvalp = val0;
 
       PARSING_STOP ("relunit");
@@ -2054,12 +2313,12 @@ parse_relunit (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_dayshift (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("dayshift", p0);
+  PARSING_START ("dayshift", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tDAY_SHIFT)  /* tDAY_SHIFT */
     {
       intmax_t rel_value = lvalp->intval;
@@ -2070,7 +2329,7 @@ parse_dayshift (YYSTYPE *lvalp, parser_control *pc)
       return STATE_ACCEPT;
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("dayshift");
@@ -2089,18 +2348,18 @@ parse_dayshift (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_rel (YYSTYPE *lvalp, parser_control *pc)
 {
-  PARSING_START ("rel", pc->input);
+  PARSING_START ("rel", pc, pc->token_index);
 
-  char const *p1;
+  idx_t i1;
   YYSTYPE val1;
   int token;
 
-  switch (parse_relunit (lvalp, pc))
+  switch (PARSE_MEMO (MEMO_RELUNIT, parse_relunit, lvalp, pc))
     {
     case STATE_ACCEPT:
-      p1 = pc->input;
+      i1 = pc->token_index;
       val1 = *lvalp;
-      token = yylex (lvalp, pc);
+      token = next_token (lvalp, pc);
       if (token == tAGO)  /* relunit tAGO */
         {
           if (apply_relative_time (pc, val1.rel, lvalp->intval))
@@ -2115,7 +2374,7 @@ parse_rel (YYSTYPE *lvalp, parser_control *pc)
         {
           if (apply_relative_time (pc, val1.rel, 1))
             {
-              pc->input = p1;
+              pc->token_index = i1;
               *lvalp = val1;
 
               PARSING_ACCEPT ("parse_rel", "relunit");
@@ -2208,12 +2467,12 @@ digits_to_date_time (parser_control *pc, textint text_int)
 static int
 parse_number (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("number", p0);
+  PARSING_START ("number", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tUNUMBER)  /* tUNUMBER */
     {
       digits_to_date_time (pc, lvalp->textintval);
@@ -2222,7 +2481,7 @@ parse_number (YYSTYPE *lvalp, parser_control *pc)
       return STATE_ACCEPT;
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("number");
@@ -2239,18 +2498,19 @@ parse_number (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_hybrid (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
 
-  PARSING_START ("hybrid", p0);
+  PARSING_START ("hybrid", pc, i0);
 
-  int token = yylex (lvalp, pc);
+  int token = next_token (lvalp, pc);
   if (token == tUNUMBER)
     {
       YYSTYPE val1 = *lvalp;
 
       /* tUNUMBER relunit_snumber */
-      switch (parse_relunit_snumber (lvalp, pc))
+      switch (PARSE_MEMO (MEMO_RELUNIT_SNUMBER,
+                          parse_relunit_snumber, lvalp, pc))
         {
         case STATE_ACCEPT:
           /* Hybrid all-digit and relative offset, so that we accept e.g.,
@@ -2268,13 +2528,88 @@ parse_hybrid (YYSTYPE *lvalp, parser_control *pc)
         }
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("hybrid");
   return STATE_STOP;
 }
 
+/* Alternatives of item, which are tried in this order.  */
+enum
+{
+  ITEM_DATETIME = 1 << 0,
+  ITEM_DATE = 1 << 1,
+  ITEM_HYBRID = 1 << 2,
+  ITEM_TIME = 1 << 3,
+  ITEM_LOCAL_ZONE = 1 << 4,
+  ITEM_ZONE = 1 << 5,
+  ITEM_DAY = 1 << 6,
+  ITEM_REL = 1 << 7,
+  ITEM_NUMBER = 1 << 8,
+  ITEM_J = 1 << 9
+};
+
+/* Alternatives of item which can begin with the kind of a token.  */
+static unsigned short const item_predictions[tUDECIMAL_NUMBER + 1] =
+{
+  ['J'] = ITEM_J,
+  ['T'] = ITEM_ZONE,
+  [tYEAR_UNIT] = ITEM_REL,
+  [tMONTH_UNIT] = ITEM_REL,
+  [tHOUR_UNIT] = ITEM_REL,
+  [tMINUTE_UNIT] = ITEM_REL,
+  [tSEC_UNIT] = ITEM_REL,
+  [tDAY_UNIT] = ITEM_REL,
+  [tDAY_SHIFT] = ITEM_REL,
+  [tDAY] = ITEM_DAY,
+  [tDAYZONE] = ITEM_ZONE,
+  [tLOCAL_ZONE] = ITEM_LOCAL_ZONE,
+  [tMONTH] = ITEM_DATE,
+  [tORDINAL] = ITEM_DAY | ITEM_REL,
+  [tZONE] = ITEM_ZONE,
+  [tSNUMBER] = ITEM_REL,
+  [tUNUMBER] = ITEM_DATETIME | ITEM_DATE | ITEM_HYBRID | ITEM_TIME
+               | ITEM_DAY | ITEM_REL | ITEM_NUMBER,
+  [tSDECIMAL_NUMBER] = ITEM_REL,
+  [tUDECIMAL_NUMBER] = ITEM_REL
+};
+
+/* Alternatives of item which can continue with the kind of a token after
+   tUNUMBER or tORDINAL, except for number accepting only tUNUMBER.  */
+static unsigned short const item_number_predictions[tUDECIMAL_NUMBER + 1] =
+{
+  ['/'] = ITEM_DATE,
+  [':'] = ITEM_TIME,
+  [tYEAR_UNIT] = ITEM_REL,
+  [tMONTH_UNIT] = ITEM_REL,
+  [tHOUR_UNIT] = ITEM_REL,
+  [tMINUTE_UNIT] = ITEM_REL,
+  [tSEC_UNIT] = ITEM_REL,
+  [tDAY_UNIT] = ITEM_REL,
+  [tDAY] = ITEM_DAY,
+  [tMERIDIAN] = ITEM_TIME,
+  [tMONTH] = ITEM_DATE,
+  [tSNUMBER] = ITEM_DATETIME | ITEM_DATE | ITEM_HYBRID | ITEM_TIME
+};
+
+/* Return the alternatives of item which may be accepted for the first one
+   or two tokens remaining in *PC.  Every other alternative stops without
+   changing *PC, so that it can be skipped without changing the result.  */
+static int
+predict_item (parser_control const *pc)
+{
+  lexed_token const *tp = pc->tokens + pc->token_index;
+  int predictions = item_predictions[tp->type];
+
+  if (tp->type == tUNUMBER)
+    predictions &= item_number_predictions[tp[1].type] | ITEM_NUMBER;
+  else if (tp->type == tORDINAL)
+    predictions &= item_number_predictions[tp[1].type];
+
+  return predictions;
+}
+
 /* Parse the leading string as item.
 
    item := datetime
@@ -2288,79 +2623,108 @@ parse_hybrid (YYSTYPE *lvalp, parser_control *pc)
          | hybrid
          | 'J'
 
-   If accepted as item, return STATE_ACCEPT, or if its value is incorrect,
+   Try only alternatives predicted by the first one or two tokens. If
+   accepted as item, return STATE_ACCEPT, or if its value is incorrect,
    return STATE_ABORT, otherwise, return STATE_STOP.  */
 
 static int
 parse_item (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
+  idx_t i0 = pc->token_index;
   YYSTYPE val0 = *lvalp;
+  int predictions = predict_item (pc);
+  int state;
 
-  PARSING_START ("item", pc->input);
+  PARSING_START ("item", pc, pc->token_index);
 
   /* datetime */
-  switch (parse_datetime (lvalp, pc))
-    {
-     case STATE_ACCEPT:
-       pc->times_seen++;
-       pc->dates_seen++;
-       PARSING_ACCEPT ("item", "datetime");
-       return STATE_ACCEPT;
-     case STATE_ABORT:
-       return STATE_ABORT;
-     }
+  if (predictions & ITEM_DATETIME)
+    switch (parse_datetime (lvalp, pc))
+      {
+      case STATE_ACCEPT:
+        pc->times_seen++;
+        pc->dates_seen++;
+        PARSING_ACCEPT ("item", "datetime");
+        return STATE_ACCEPT;
+      case STATE_ABORT:
+        return STATE_ABORT;
+      }
 
   /* date */
-  int state = parse_date (lvalp, pc);
-  if (! next_parsing (state, "item", "date", &pc->dates_seen))
-    return state;
+  if (predictions & ITEM_DATE)
+    {
+      state = parse_date (lvalp, pc);
+      if (! next_parsing (state, "item", "date", &pc->dates_seen, pc))
+        return state;
+    }
 
   /* hybrid */
-  state = parse_hybrid (lvalp, pc);
-  if (! next_parsing (state, "item", "hybrid", NULL))
-    return state;
+  if (predictions & ITEM_HYBRID)
+    {
+      state = parse_hybrid (lvalp, pc);
+      if (! next_parsing (state, "item", "hybrid", NULL, pc))
+        return state;
+    }
 
   /* time */
-  state = parse_time (lvalp, pc);
-  if (! next_parsing (state, "item", "time", &pc->times_seen))
-    return state;
+  if (predictions & ITEM_TIME)
+    {
+      state = parse_time (lvalp, pc);
+      if (! next_parsing (state, "item", "time", &pc->times_seen, pc))
+        return state;
+    }
 
   /* local_zone */
-  state = parse_local_zone (lvalp, pc);
-  if (! next_parsing (state, "item", "local_zone", &pc->local_zones_seen))
-    return state;
+  if (predictions & ITEM_LOCAL_ZONE)
+    {
+      state = parse_local_zone (lvalp, pc);
+      if (! next_parsing (state, "item", "local_zone",
+                          &pc->local_zones_seen, pc))
+        return state;
+    }
 
   /* zone */
-  state = parse_zone (lvalp, pc);
-  if (! next_parsing (state, "item", "zone", &pc->zones_seen))
-    return state;
+  if (predictions & ITEM_ZONE)
+    {
+      state = parse_zone (lvalp, pc);
+      if (! next_parsing (state, "item", "zone", &pc->zones_seen, pc))
+        return state;
+    }
 
   /* day */
-  state = parse_day (lvalp, pc);
-  if (! next_parsing (state, "item", "day", &pc->days_seen))
-    return state;
+  if (predictions & ITEM_DAY)
+    {
+      state = parse_day (lvalp, pc);
+      if (! next_parsing (state, "item", "day", &pc->days_seen, pc))
+        return state;
+    }
 
   /* rel */
-  state = parse_rel (lvalp, pc);
-  if (! next_parsing (state, "item", "rel", NULL))
-    return state;
+  if (predictions & ITEM_REL)
+    {
+      state = parse_rel (lvalp, pc);
+      if (! next_parsing (state, "item", "rel", NULL, pc))
+        return state;
+    }
 
   /* number */
-  state = parse_number (lvalp, pc);
-  if (! next_parsing (state, "item", "number", NULL))
-    return state;
+  if (predictions & ITEM_NUMBER)
+    {
+      state = parse_number (lvalp, pc);
+      if (! next_parsing (state, "item", "number", NULL, pc))
+        return state;
+    }
 
-  int token = yylex (lvalp, pc);
-  if (token == 'J')  /* 'J' */
+  if (predictions & ITEM_J)
     {
+      next_token (lvalp, pc);  /* 'J' */
       pc->J_zones_seen++;
 
       PARSING_ACCEPT ("item", "'J'");
       return STATE_ACCEPT;
     }
 
-  pc->input = p0;
+  pc->token_index = i0;
   *lvalp = val0;
 
   PARSING_STOP ("item");
@@ -2368,21 +2732,19 @@ parse_item (YYSTYPE *lvalp, parser_control *pc)
 }
 
 #ifdef TEST
-/* The count of nesting items.  */
-static unsigned int nesting_items = 0;
-
 /* Output the state of parsing an expression in the nest of items.  */
 # define PARSING_ITEMS(state,nest,symbol,expr) \
-           (parsing_output \
+           (pc->parsing_output \
             ? print_parsing_state (state, nest, symbol, expr) : 0)
-# define PARSING_START_ITEMS(nest,symbol,expr) \
-           PARSING_ITEMS (STATE_START, nest, symbol, expr)
+# define PARSING_START_ITEMS(nest,symbol,pc,index) \
+           PARSING_ITEMS (STATE_START, nest, symbol, \
+                          (pc)->tokens[index].input)
 # define PARSING_ACCEPT_ITEMS(nest,symbol,expr) \
            PARSING_ITEMS (STATE_ACCEPT, nest, symbol, expr)
 # define PARSING_STOP_ITEMS(nest,symbol) \
            PARSING_ITEMS (STATE_STOP, nest, symbol, NULL)
 #else
-# define PARSING_START_ITEMS(nest,symbol,expr)
+# define PARSING_START_ITEMS(nest,symbol,pc,index)
 # define PARSING_ACCEPT_ITEMS(nest,symbol,expr)
 # define PARSING_STOP_ITEMS(nest,symbol)
 #endif
@@ -2391,45 +2753,54 @@ static unsigned int nesting_items = 0;
 
    items := empty | item items
 
+   Parse item repeatedly in the loop instead of the recursion for items, so
+   that the depth of the stack is bounded regardless of the number of items.
    If accepted as items, return STATE_ACCEPT, or if its value is incorrect,
    return STATE_ABORT, otherwise, return STATE_STOP.  */
 
 static int
 parse_items (YYSTYPE *lvalp, parser_control *pc)
 {
-  char const *p0 = pc->input;
-  YYSTYPE val0 = *lvalp;
-
-  PARSING_START_ITEMS (++nesting_items, "items", p0);
+  idx_t item_num = 0;
+  int state;
 
-  int token = yylex (lvalp, pc);
-  if (token == '\0')  /* empty */
+  for (;;)
     {
-      PARSING_ACCEPT_ITEMS (nesting_items--, "items", "empty");
-      return STATE_ACCEPT;
-    }
+      PARSING_START_ITEMS (item_num + 1, "items", pc, pc->token_index);
 
-  pc->input = p0;
-  *lvalp = val0;
+      if (pc->tokens[pc->token_index].type == '\0')  /* empty */
+        {
+          PARSING_ACCEPT_ITEMS (item_num + 1, "items", "empty");
+          state = STATE_ACCEPT;
+          break;
+        }
 
-  int state;
-  switch (parse_item (lvalp, pc))
-    {
-    case STATE_ACCEPT:
-      state = parse_items (lvalp, pc);
-      if (state == STATE_ACCEPT)  /* item items */
+      state = parse_item (lvalp, pc);
+      if (state != STATE_ACCEPT)
         {
-          PARSING_ACCEPT_ITEMS (nesting_items--, "items", "item items");
-          return STATE_ACCEPT;
+          if (state == STATE_ABORT)
+            return STATE_ABORT;
+
+          PARSING_STOP_ITEMS (item_num + 1, "items");
+          break;
         }
-      else if (state == STATE_STOP)
-        break;
-    case STATE_ABORT:
-      return STATE_ABORT;
+
+      item_num++;
     }
 
-  PARSING_STOP_ITEMS (nesting_items--, "items");
-  return STATE_STOP;
+#ifdef TEST
+  /* Output the state of items which each item is followed by, in the same
+     order as unwinding the recursion.  */
+  for (; item_num > 0; item_num--)
+    {
+      if (state == STATE_ACCEPT)  /* item items */
+        PARSING_ACCEPT_ITEMS (item_num, "items", "item items");
+      else
+        PARSING_STOP_ITEMS (item_num, "items");
+    }
+#endif
+
+  return state;
 }
 
 /* Parse the leading string as spec.
@@ -2442,28 +2813,36 @@ parse_items (YYSTYPE *lvalp, parser_control *pc)
 static int
 parse_spec (YYSTYPE *lvalp, parser_control *pc)
 {
-  PARSING_START ("spec", pc->input);
+  PARSING_START ("spec", pc, pc->token_index);
 
   /* timespec */
   int state = parse_timespec (lvalp, pc);
-  if (! next_parsing (state, "spec", "timespec", NULL))
+  if (! next_parsing (state, "spec", "timespec", NULL, pc))
     return state;
 
   /* items */
   state = parse_items (lvalp, pc);
-  if (! next_parsing (state, "spec", "items", NULL))
+  if (! next_parsing (state, "spec", "items", NULL, pc))
     return state;
 
   PARSING_STOP ("spec");
   return STATE_STOP;
 }
 
-/* Parse a date and time string. */
+/* Parse tokens lexed from a date and time string.
+
+   The time of parsing is linear in the length of the string, because
+   tokenize reads each character a bounded number of times to lex only
+   once, including parenthesized comments, each alternative predicted
+   for an item looks ahead only a bounded number of tokens, and tokens of
+   an accepted item are never parsed again.  The depth of the stack is
+   also bounded since no rule is recursive except for items parsed in the
+   loop.  */
 
 static bool
 parse (parser_control *pc)
 {
-  YYSTYPE lval;
+  YYSTYPE lval = { 0 };
   int ret = parse_spec (&lval, pc);
   if (ret == STATE_ACCEPT)  /* spec */
     return true;
@@ -2551,11 +2930,60 @@ populate_local_time_zone_table (parser_control *pc, TM const *lct)
   e[1].name = NULL;
 }
 
+/* Populate PC's local time zone table with the names used at START and
+   in the next three calendar quarters.  Return true if successful.  */
+
+static bool
+probe_local_time_zone_table (parser_control *pc, intmax_t Start)
+{
+  TM tmp;
+  if (! localtimew (&Start, &tmp))
+    return false;
+
+  populate_local_time_zone_table (pc, &tmp);
+
+  /* Probe the names used in the next three calendar quarters, looking
+     for a tm_isdst different from the one we already have.  */
+  for (int quarter = 1; quarter <= 3; quarter++)
+    {
+      intmax_t probe;
+      if (IMAX_ADD_WRAPV (Start, quarter * (90 * 24 * 60 * 60), &probe))
+        break;
+      TM probe_tm;
+      if (localtimew (&probe, &probe_tm)
+          && (! pc->local_time_zone_table[0].name
+              || probe_tm.tm_isdst != pc->local_time_zone_table[0].value))
+        {
+          populate_local_time_zone_table (pc, &probe_tm);
+          if (pc->local_time_zone_table[1].name)
+            {
+              if (! strcmp (pc->local_time_zone_table[0].name,
+                            pc->local_time_zone_table[1].name))
+                {
+                  /* This locale uses the same abbreviation for standard and
+                     daylight times.  So if we see that abbreviation, we don't
+                     know whether it's daylight time.  */
+                  pc->local_time_zone_table[0].value = -1;
+                  pc->local_time_zone_table[1].name = NULL;
+                }
+
+              break;
+            }
+        }
+    }
+
+  return true;
+}
+
 /* Parse a date/time string, storing the resulting parameters of time into
    *RESULT.  The string itself is pointed to by P which can be an incomplete
-   or relative time specification.  Return true if successful.  */
-bool
-parseft (FT_PARSING *result, char const *p)
+   or relative time specification.  If PARSING_OUTPUT is true, output the
+   state of each parsing in the test command.  Return true if successful.
+
+   All mutable state is kept in the parser_control on the stack, so that
+   this function can be called by threads at the same time.  */
+static bool
+parse_string (FT_PARSING *result, char const *p, bool parsing_output)
 {
   FT_CHANGE ft_chg =
     (FT_CHANGE) { .date_set = false, .year = -1, .hour = -1, .minutes = -1,
@@ -2579,12 +3007,6 @@ parseft (FT_PARSING *result, char const *p)
      to-temporary, which would trigger a -Wjump-misses-init warning.  */
   const relative_time rel_time_0 = RELATIVE_TIME_0;
 
-  /* Never use the environment variable of a time zone ('TZ="XXX"').  */
-
-  TM tmp;
-  if (! localtimew (&Start, &tmp))
-    return false;
-
   /* As documented, be careful to treat the empty string just like
      a date string of "0".  Without this, an empty string would be
      declared invalid when parsed during a DST transition.  */
@@ -2615,39 +3037,15 @@ parseft (FT_PARSING *result, char const *p)
   pc.dsts_seen = 0;
   pc.zones_seen = 0;
   pc.year_seen = false;
+#ifdef TEST
+  pc.parsing_output = parsing_output;
+#endif
 
+  /* Never use the environment variable of a time zone ('TZ="XXX"').
+     Local zone abbreviations have been probed if the index is loaded.  */
   pc.local_time_zone_table[0].name = NULL;
-  populate_local_time_zone_table (&pc, &tmp);
-
-  /* Probe the names used in the next three calendar quarters, looking
-     for a tm_isdst different from the one we already have.  */
-  for (int quarter = 1; quarter <= 3; quarter++)
-    {
-      intmax_t probe;
-      if (IMAX_ADD_WRAPV (Start, quarter * (90 * 24 * 60 * 60), &probe))
-        break;
-      TM probe_tm;
-      if (localtimew (&probe, &probe_tm)
-          && (! pc.local_time_zone_table[0].name
-              || probe_tm.tm_isdst != pc.local_time_zone_table[0].value))
-        {
-          populate_local_time_zone_table (&pc, &probe_tm);
-          if (pc.local_time_zone_table[1].name)
-            {
-              if (! strcmp (pc.local_time_zone_table[0].name,
-                            pc.local_time_zone_table[1].name))
-                {
-                  /* This locale uses the same abbreviation for standard and
-                     daylight times.  So if we see that abbreviation, we don't
-                     know whether it's daylight time.  */
-                  pc.local_time_zone_table[0].value = -1;
-                  pc.local_time_zone_table[1].name = NULL;
-                }
-
-              break;
-            }
-        }
-    }
+  if (! zone_index.entries && ! probe_local_time_zone_table (&pc, Start))
+    return false;
 
 #ifndef USE_TM_GLIBC
   pc.ansi_cp = 0;
@@ -2659,7 +3057,26 @@ parseft (FT_PARSING *result, char const *p)
     pc.ansi_cp = atoi (buff);
 #endif
 
-  if (! parse (&pc))
+  /* Lex the input string only once, into the array on the stack unless
+     it contains too many tokens.  */
+  lexed_token tokens[TOKEN_BUFSIZE];
+  bool parsed = tokenize (&pc, tokens, TOKEN_BUFSIZE);
+
+  if (parsed)
+    {
+#ifdef USE_PARSEFT_MEMO
+      /* Parse without memoization if failing to allocate memory.  */
+      pc.memo = calloc (pc.token_num * MEMO_RULE_NUM, sizeof *pc.memo);
+#endif
+      parsed = parse (&pc);
+#ifdef USE_PARSEFT_MEMO
+      free (pc.memo);
+#endif
+    }
+
+  if (pc.tokens != tokens)
+    free (pc.tokens);
+  if (! parsed)
     return false;
 
   if (! pc.timespec_seen)
@@ -2733,12 +3150,173 @@ parseft (FT_PARSING *result, char const *p)
   return true;
 }
 
+/* Parse a date/time string, storing the resulting parameters of time into
+   *RESULT.  Return true if successful.  */
+bool
+parseft (FT_PARSING *result, char const *p)
+{
+  return parse_string (result, p, false);
+}
+
+/* The list of time zone abbreviations loaded from TZif files.  */
+typedef struct
+{
+  loaded_zone *zones;
+  idx_t num;
+  idx_t alloc;
+} loaded_zones;
+
+/* Add the abbreviation of a local time type, whose UTC offset and DST
+   flag are UTOFF and ISDST, into *ARG.  Return false if memory is
+   exhausted.  */
+
+static bool
+add_loaded_zone (const char *abbr, long int utoff, bool isdst, void *arg)
+{
+  loaded_zones *lz = arg;
+  loaded_zone *zone;
+  idx_t len = strlen (abbr);
+  idx_t i;
+
+  /* Only alphabetic abbreviations can be lexed as a word, and a letter is
+     a military time zone.  */
+  if (len < 2 || len >= TIME_ZONE_BUFSIZE)
+    return true;
+  for (i = 0; i < len; i++)
+    if (! isalpha (to_uchar (abbr[i])))
+      return true;
+
+  if (lz->num >= lz->alloc)
+    {
+      idx_t alloc = lz->alloc ? lz->alloc * 2 : 1024;
+      loaded_zone *zones = realloc (lz->zones, alloc * sizeof *zones);
+      if (! zones)
+        return false;
+
+      lz->zones = zones;
+      lz->alloc = alloc;
+    }
+
+  zone = lz->zones + lz->num++;
+  for (i = 0; i <= len; i++)
+    zone->name[i] = toupper (to_uchar (abbr[i]));
+
+  /* The offset of DST is parsed as the standard offset plus 1 hour.  */
+  zone->type = isdst ? tDAYZONE : tZONE;
+  zone->value = isdst ? utoff - HOUR (1) : utoff;
+
+  return true;
+}
+
+static int
+compare_loaded_zones (const void *a, const void *b)
+{
+  return strcmp (((const loaded_zone *) a)->name,
+                 ((const loaded_zone *) b)->name);
+}
+
+/* Insert the entry of a time zone abbreviation into the index unless its
+   name has already been inserted.  */
+
+static void
+insert_zone_index (char const *name, int type, int value)
+{
+  table *tp = zone_index_slot (name);
+
+  if (! tp->name)
+    *tp = (table) { .name = name, .type = type, .value = value };
+}
+
+/* Load abbreviations of time zones from TZif files under DIR, or TZDIR or
+   "/usr/share/zoneinfo" if NULL, into the index looked up by parseft with
+   local zone abbreviations probed at current time.  Abbreviations used
+   for different UTC offsets or DST flags since 1970 are not loaded.  This
+   must be called before threads are started.  Return true if loaded,
+   otherwise, false.  */
+
+bool
+loadtzabbrs (const char *dir)
+{
+  loaded_zones lz = (loaded_zones) { .zones = NULL, .num = 0, .alloc = 0 };
+  FT now;
+  intmax_t Start;
+  int Start_ns;
+  parser_control pc;
+  table const *tp;
+  idx_t i, j, n, size;
+
+  pc.local_time_zone_table[0].name = NULL;
+  if (! currentft (&now) || ! ft2sec (&now, &Start, &Start_ns)
+      || ! probe_local_time_zone_table (&pc, Start)
+      || ! tz_walktypes (dir, add_loaded_zone, &lz))
+    {
+      free (lz.zones);
+      return false;
+    }
+
+  /* Drop abbreviations which are ambiguous.  */
+  qsort (lz.zones, lz.num, sizeof *lz.zones, compare_loaded_zones);
+  for (i = n = 0; i < lz.num; i = j)
+    {
+      bool ambiguous = false;
+
+      for (j = i + 1;
+           j < lz.num && strcmp (lz.zones[i].name, lz.zones[j].name) == 0;
+           j++)
+        ambiguous |= (lz.zones[i].type != lz.zones[j].type
+                      || lz.zones[i].value != lz.zones[j].value);
+
+      if (! ambiguous)
+        lz.zones[n++] = lz.zones[i];
+    }
+
+  /* Count entries of static tables as signed to compare with the size.  */
+  idx_t static_num = (sizeof universal_time_zone_table / sizeof (table)
+                      + sizeof time_zone_table / sizeof (table));
+
+  for (size = 1; size < 2 * (n + 2 + static_num); size *= 2)
+    ;
+
+  table *entries = calloc (size, sizeof *entries);
+  if (! entries)
+    {
+      free (lz.zones);
+      return false;
+    }
+
+  free (zone_index.entries);
+  free (zone_index.loaded);
+  zone_index.entries = entries;
+  zone_index.mask = size - 1;
+  zone_index.loaded = lz.zones;
+  memcpy (zone_index.tz_abbr, pc.tz_abbr, sizeof pc.tz_abbr);
+
+  for (tp = universal_time_zone_table; tp->name; tp++)
+    insert_zone_index (tp->name, tp->type, tp->value);
+  for (i = 0; i < 2 && pc.local_time_zone_table[i].name; i++)
+    insert_zone_index (zone_index.tz_abbr[i], tLOCAL_ZONE,
+                       pc.local_time_zone_table[i].value);
+  for (tp = time_zone_table; tp->name; tp++)
+    insert_zone_index (tp->name, tp->type, tp->value);
+  for (i = 0; i < n; i++)
+    insert_zone_index (lz.zones[i].name, lz.zones[i].type,
+                       lz.zones[i].value);
+
+  return true;
+}
+
 #ifdef TEST
+# include <errno.h>
 # include <unistd.h>
 
+# include "argempty.h"
+# include "argnum.h"
 # include "cmdtmio.h"
+# include "error.h"
 # include "exit.h"
 
+char *program_name = "parseft";
+
 static void
 usage (int status)
 {
@@ -2748,7 +3326,11 @@ by which file time is changed. Display those values if parsing is\n\
 completed and parameters are not duplicate, otherwise, nothing.\n\
 \n\
 Options:\n\
-  -p   output the state of each parsing instead of values.\
+  -l          load abbreviations of time zones from TZif files under\n\
+              TZDIR or /usr/share/zoneinfo before parsing\n\
+  -n NUMBER   parse NUMBER times and display the average nanoseconds\n\
+              of processor time for parsing instead of values\n\
+  -p          output the state of each parsing instead of values.\
 ", true, false, 0);
   exit (status);
 }
@@ -2758,12 +3340,28 @@ main (int argc, char **argv)
 {
   FT_PARSING result;
   FT_CHANGE *ft_chgp = &(result.change);
-  int c;
+  int repeat_num = 0;
+  int c, i;
+  int set_num;
+  char *endptr;
+  bool parsing_output = false;
 
-  while ((c = getopt (argc, argv, ":p")) != -1)
+  while ((c = getopt (argc, argv, ":ln:p")) != -1)
     {
       switch (c)
         {
+        case 'l':
+          if (! loadtzabbrs (NULL))
+            error (EXIT_FAILURE, errno,
+                   "cannot load abbreviations of time zones");
+          break;
+        case 'n':
+          set_num = argnumuint (optarg, &repeat_num, &endptr);
+          if (set_num < 0)
+            error (EXIT_FAILURE, 0, "invalid number '%s'", optarg);
+          else if (set_num == 0 || repeat_num == 0 || ! argempty (endptr))
+            usage (EXIT_FAILURE);
+          break;
         case 'p':
           parsing_output = true;
           break;
@@ -2775,10 +3373,23 @@ main (int argc, char **argv)
   argc -= optind;
   argv += optind;
 
-  if (argc <= 0)
+  if (argc <= 0 || (repeat_num > 0 && parsing_output))
     usage (EXIT_FAILURE);
 
-  if (! parseft (&result, *argv))
+  if (repeat_num > 0)
+    {
+      bool parsed = true;
+      clock_t start = clock ();
+
+      for (i = 0; i < repeat_num; i++)
+        parsed &= parseft (&result, *argv);
+
+      double elapse = (double) (clock () - start) / CLOCKS_PER_SEC;
+      printelapse (false, elapse * 1000000000 / repeat_num, -1);
+
+      return parsed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  else if (! parse_string (&result, *argv, parsing_output))
     return EXIT_FAILURE;
   else if (parsing_output)
     return EXIT_SUCCESS;
@@ -40,8 +40,12 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "adjusttm.h"
 #include "ft.h"
+#include "ftsec.h"
 #include "posixtm.h"
+#include "splitlines.h"
+#include "swardigits.h"
 #include "wintm.h"
 
 /* ISDIGIT differs from isdigit, as follows:
@@ -194,10 +198,114 @@ posix_time_parse (TM *tm, const char *s, unsigned int syntax_bits)
   return 0;
 }
 
-/* Parse a POSIX-style date, returning true if successful.  */
+/* The mask of digits in "CCYYMMDD" and "hhmm.ss", and the value and
+   mask of '.' and the null character in the latter.  */
+#define POSIX_TIME_DIGITS 0x00ffff00ffffffffULL
+#define POSIX_TIME_DOT    0x0000002e00000000ULL
+#define POSIX_TIME_DOTEND 0xff0000ff00000000ULL
+
+/* The length of "CCYYMMDDhhmm.ss" in the fixed layout.  */
+#define POSIX_TIME_FIXED_LEN 15
+
+/* The seconds before and after a time, in which the UTC offset of local
+   time is assumed not to be changed and restored.  */
+#define UTCOFF_TERM_SECONDS (SECONDS_IN_DAY / 4)
+
+/* Cache the specified UTC offset of local time at T into *UTCOFF if it's
+   the same before and after the term around T, joining the term cached
+   already if overlapped.  */
+static void
+cache_utcoff (struct posix_utcoff *utcoff, intmax_t t, long int value)
+{
+  intmax_t from = t - UTCOFF_TERM_SECONDS;
+  intmax_t to = t + UTCOFF_TERM_SECONDS;
+  TM tm;
+
+  if (! localtimew (&from, &tm) || tm.tm_gmtoff != value
+      || ! localtimew (&to, &tm) || tm.tm_gmtoff != value)
+    return;
+
+  if (utcoff->cached && utcoff->value == value
+      && from <= utcoff->to && to >= utcoff->from)
+    {
+      if (from < utcoff->from)
+	utcoff->from = from;
+      if (to > utcoff->to)
+	utcoff->to = to;
+    }
+  else
+    {
+      utcoff->cached = true;
+      utcoff->from = from;
+      utcoff->to = to;
+      utcoff->value = value;
+    }
+}
+
+/* Parse S as "CCYYMMDDhhmm.ss", which is the most usual for touch -t,
+   by digit pairs in two words and set seconds since 1970-01-01 00:00 UTC
+   calculated directly by days elapsed from the date and the UTC offset
+   cached in *UTCOFF into *P.  Return 1 if set, -1 if a date or time is
+   invalid, otherwise, 0 if not in the fixed layout or outside the cached
+   term, which must be parsed by mktimew.  */
+static int
+posix_time_fixed (intmax_t *p, const char *s, unsigned int syntax_bits,
+		  const struct posix_utcoff *utcoff)
+{
+  int len;
+
+  if ((syntax_bits & (PDS_LEADING_YEAR | PDS_CENTURY | PDS_SECONDS))
+      != (PDS_LEADING_YEAR | PDS_CENTURY | PDS_SECONDS))
+    return 0;
+
+  /* Check the length before reading characters at once.  */
+  for (len = 0; len < POSIX_TIME_FIXED_LEN; len++)
+    if (s[len] == '\0')
+      return 0;
+  if (s[len] != '\0')
+    return 0;
+
+  uint64_t date_word = swarload (s);
+  uint64_t time_word = swarload (s + 8);
+
+  if (! swardigits (date_word, ~0ULL)
+      || ! swardigits (time_word, POSIX_TIME_DIGITS)
+      || (time_word & POSIX_TIME_DOTEND) != POSIX_TIME_DOT)
+    return 0;
+
+  int year = SWAR_2DIGITS (date_word, 0) * 100 + SWAR_2DIGITS (date_word, 2);
+  int month = SWAR_2DIGITS (date_word, 4);
+  int day = SWAR_2DIGITS (date_word, 6);
+  int hour = SWAR_2DIGITS (time_word, 0);
+  int min = SWAR_2DIGITS (time_word, 2);
+  int sec = SWAR_2DIGITS (time_word, 5);
+
+  /* Reject dates like "September 31" and times like "25:61".  */
+  if (month < 1 || month > 12 || day < 1
+      || day > YEAR_DAYS (year, month) - YEAR_DAYS (year, month - 1)
+      || hour > 23 || min > 59 || sec > 59)
+    return -1;
+
+  if (! utcoff->cached)
+    return 0;
+
+  intmax_t t = EPOCH_DAYS (year, YEAR_DAYS (year, month - 1) + day - 1)
+	       * SECONDS_IN_DAY + SECONDS_AT (hour, min, sec) - utcoff->value;
+  if (t < utcoff->from || t > utcoff->to)
+    return 0;
+
+  *p = t;
+  return 1;
+}
+
+/* Parse a POSIX-style date, returning true if successful.  If UTCOFF is
+   not NULL, the UTC offset of local time at the date converted by mktimew
+   is cached into *UTCOFF, by which the following dates around it in the
+   fixed layout are converted directly.  */
 
 bool
-posixtime (intmax_t *p, const char *s, unsigned int syntax_bits)
+posixtime (intmax_t *p, const char *s, unsigned int syntax_bits,
+	   struct posix_utcoff *utcoff)
 {
   TM tm0
 #ifdef lint
@@ -212,6 +320,13 @@ posixtime (intmax_t *p, const char *s, unsigned int syntax_bits)
   TM const *tm;
   intmax_t t;
 
+  if (utcoff)
+    {
+      int fixed = posix_time_fixed (p, s, syntax_bits, utcoff);
+      if (fixed != 0)
+	return fixed > 0;
+    }
+
   if (posix_time_parse (&tm0, s, syntax_bits))
     return false;
 
@@ -239,16 +354,69 @@ posixtime (intmax_t *p, const char *s, unsigned int syntax_bits)
       | (tm0.tm_sec ^ tm->tm_sec))
     return false;
 
+  if (utcoff)
+    cache_utcoff (utcoff, t, tm->tm_gmtoff);
+
   *p = t;
   return true;
 }
 
-#ifdef TEST_POSIXTIME
+/* Parameters of posixtimes passed to posixrec.  */
+struct posixrec_arg
+{
+  unsigned int syntax_bits;
+  struct posix_utcoff *utcoff;
+  struct secrec *recs;
+};
+
+/* Parse the first field of a line as a POSIX-style date into the record
+   at INDEX with parameters in *ARG.  */
+
+static void
+posixrec (char *field, char *rest, size_t index, void *arg)
+{
+  struct posixrec_arg *rec_arg = arg;
+  struct secrec *rec = rec_arg->recs + index;
+
+  rec->nsec = posixtime (&rec->seconds, field, rec_arg->syntax_bits,
+			 rec_arg->utcoff) ? 0 : -1;
+}
+
+/* Parse the first field of lines, separated by a space or tab, in BUF
+   of SIZE bytes as POSIX-style dates with the UTC offset cached into
+   *UTCOFF and set those seconds into RECS up to REC_NUM, whose nanoseconds
+   is 0 or -1 if not parsed.  The field and newline of parsed lines are
+   terminated by the null character in BUF.  Store the pointer to the line
+   not parsed because its newline is not included in BUF or RECS is filled
+   into *ENDPTR.  Return the number of parsed lines.  */
+
+size_t
+posixtimes (char *buf, size_t size, unsigned int syntax_bits,
+	    struct posix_utcoff *utcoff, struct secrec *recs,
+	    size_t rec_num, char **endptr)
+{
+  struct posixrec_arg rec_arg = { syntax_bits, utcoff, recs };
+
+  return splitlines (buf, size, " \t\r", rec_num, posixrec, &rec_arg,
+		     endptr);
+}
+
+#ifdef TEST
+# include <errno.h>
+# include <unistd.h>
+
+# include "argempty.h"
+# include "argnum.h"
+# include "cmdtmio.h"
+# include "error.h"
+# include "exit.h"
+
 /*
     Test mainly with syntax_bits == 13
     (aka: (PDS_LEADING_YEAR | PDS_CENTURY | PDS_SECONDS))
 
-    This test data assumes Universal Time, e.g., TZ="UTC0".
+    This test data assumes Universal Time, e.g., TZ="UTC0", and can be
+    given to "posixtm -t" for lines whose second field is 13.
 
     This test data also assumes that time_t is signed and is at least
     39 bits wide, so that it can represent all years from 0000 through
@@ -304,37 +472,201 @@ END-DATA
 
 */
 
-# define MAX_BUFF_LEN 1024
+char *program_name = "posixtm";
 
-int
-main (void)
+static void
+usage (int status)
 {
-  char buff[MAX_BUFF_LEN + 1];
+  printusage ("posixtm", " [[CC]YY]MMDDhhmm[.ss]\n\
+Display seconds since 1970-01-01 00:00 UTC for the date and time in\n\
+POSIX style, which is specified to touch -t, in local time zone.\n\
+\n\
+Options:\n\
+  -b BITS   parse by BITS of POSIX date syntax flags, which is 13 for\n\
+            [[CC]YY]MMDDhhmm[.ss] by default\n\
+  -q   convert lines but don't display those results\n\
+  -t   display seconds for the first field of each line in FILE, or\n\
+       standard input if no FILE, instead of the argument by converting\n\
+       lines in bulk, or \"-\" if not converted",
+true, false, 0);
+  exit (status);
+}
 
-  buff[MAX_BUFF_LEN] = 0;
-  while (fgets (buff, MAX_BUFF_LEN, stdin) && buff[0])
+/* The size of buffer into which lines are read  */
+# define POSIX_TIME_BUFSIZE 65536
+
+/* The number of records converted from lines at once  */
+# define SECREC_NUM 1024
+
+static char buf[POSIX_TIME_BUFSIZE + 1];
+static struct secrec recs[SECREC_NUM];
+
+/* The UTC offset of local time cached by all lines  */
+static struct posix_utcoff utcoff = { false };
+
+/* Output the specified records to standard output unless QUIET is true.
+   Return true if all records are converted, otherwise, false.  */
+static bool
+printsecrecs (const struct secrec *recs, size_t rec_num, bool quiet)
+{
+  bool success = true;
+  size_t i;
+
+  for (i = 0; i < rec_num; i++)
+    {
+      if (recs[i].nsec < 0)
+	{
+	  if (! quiet)
+	    fputs ("-\n", stdout);
+	  success = false;
+	}
+      else if (! quiet)
+	printelapse (false, recs[i].seconds, -1);
+    }
+
+  return success;
+}
+
+/* Convert all lines read from STREAM by SYNTAX_BITS. Return true if
+   successfull, otherwise, false.  */
+static bool
+posixstream (FILE *stream, unsigned int syntax_bits, bool quiet)
+{
+  size_t size = 0;
+  bool success = true;
+  bool line_skipped = false;
+  bool eof = false;
+
+  while (! eof)
     {
-      char time_str[MAX_BUFF_LEN];
-      unsigned int syntax_bits;
-      time_t t;
-      if (sscanf (buff, "%s %u", time_str, &syntax_bits) != 2)
-	printf ("*\n");
+      size_t read_size = fread (buf + size, 1, POSIX_TIME_BUFSIZE - size,
+				stream);
+      char *p = buf;
+      char *endp;
+      size_t rec_num;
+
+      if (read_size == 0)
+	{
+	  if (ferror (stream))
+	    return false;
+
+	  /* Convert the last line not terminated by a newline. */
+	  eof = true;
+	  if (size == 0)
+	    break;
+	  buf[size++] = '\n';
+	}
       else
+	size += read_size;
+
+      /* Skip the rest of a line longer than the buffer. */
+      if (line_skipped)
+	{
+	  char *eol = memchr (buf, '\n', size);
+	  if (! eol)
+	    {
+	      size = 0;
+	      continue;
+	    }
+
+	  p = eol + 1;
+	  line_skipped = false;
+	}
+
+      while ((rec_num = posixtimes (p, size - (p - buf), syntax_bits,
+				    &utcoff, recs, SECREC_NUM, &endp)) > 0)
+	{
+	  success &= printsecrecs (recs, rec_num, quiet);
+	  p = endp;
+	}
+
+      /* Move the line not converted to the head of buffer, or output it
+	 as not converted if filling the buffer. */
+      size -= p - buf;
+      if (size >= POSIX_TIME_BUFSIZE)
 	{
-	  printf ("%-15s %2u ", time_str, syntax_bits);
-	  if (posixtime (&t, time_str, syntax_bits))
-	    printf ("%12ld %s", (long int) t, ctime (&t));
-	  else
-	    printf ("%12s %s", "*", "*\n");
+	  static const struct secrec long_rec = { 0, -1 };
+
+	  printsecrecs (&long_rec, 1, quiet);
+	  success = false;
+	  line_skipped = true;
+	  size = 0;
 	}
+      else
+	memmove (buf, p, size);
     }
-  exit (0);
 
+  return success;
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned int syntax_bits = PDS_LEADING_YEAR | PDS_CENTURY | PDS_SECONDS;
+  bool quiet = false;
+  bool lines_converted = false;
+  bool success = true;
+  int c;
+
+  while ((c = getopt (argc, argv, ":b:qt")) != -1)
+    {
+      char *endptr;
+      int bits;
+      int set_num;
+
+      switch (c)
+	{
+	case 'b':
+	  set_num = argnumint (optarg, &bits, &endptr);
+	  if (set_num < 0 || bits < 0)
+	    error (EXIT_FAILURE, 0, "invalid syntax bits '%s'", optarg);
+	  else if (set_num == 0 || ! argempty (endptr))
+	    usage (EXIT_FAILURE);
+	  syntax_bits = bits;
+	  break;
+	case 'q':
+	  quiet = true;
+	  break;
+	case 't':
+	  lines_converted = true;
+	  break;
+	default:
+	  usage (EXIT_FAILURE);
+	}
+    }
+
+  argc -= optind;
+  argv += optind;
+
+  if (! lines_converted)
+    {
+      intmax_t seconds;
+
+      if (argc != 1)
+	usage (EXIT_FAILURE);
+      else if (! posixtime (&seconds, *argv, syntax_bits, NULL))
+	error (EXIT_FAILURE, 0, "invalid date format '%s'", *argv);
+
+      if (! quiet)
+	printelapse (false, seconds, -1);
+    }
+  else if (argc <= 0)
+    success = posixstream (stdin, syntax_bits, quiet);
+  else
+    {
+      do
+	{
+	  FILE *stream = fopen (*argv, "rb");
+	  if (! stream)
+	    error (EXIT_FAILURE, errno, "failed to open '%s'", *argv);
+
+	  success &= posixstream (stream, syntax_bits, quiet);
+	  fclose (stream);
+	  argv++;
+	}
+      while (--argc > 0);
+    }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 #endif
-
-/*
-Local Variables:
-compile-command: "gcc -DTEST_POSIXTIME -g -O -Wall -W posixtm.c"
-End:
-*/
@@ -29,6 +29,24 @@
 # define PDS_SECONDS 8
 # define PDS_PRE_2000 16
 
-bool posixtime (intmax_t *p, const char *s, unsigned int syntax_bits);
+/* The term of seconds in which the UTC offset of local time is known to
+   be constant, which is owned by the caller of posixtime and posixtimes
+   and initialized by setting false into the cached member.  */
+struct posix_utcoff
+{
+  bool cached;
+  intmax_t from;
+  intmax_t to;
+  long int value;
+};
+
+bool posixtime (intmax_t *p, const char *s, unsigned int syntax_bits,
+		struct posix_utcoff *utcoff);
+
+struct secrec;
+
+size_t posixtimes (char *buf, size_t size, unsigned int syntax_bits,
+		   struct posix_utcoff *utcoff, struct secrec *recs,
+		   size_t rec_num, char **endptr);
 
 #endif
@@ -18,6 +18,7 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include "adjusttm.h"
@@ -40,9 +41,49 @@ static const char *wday_abbrs[] =
 #define ISO8601_WEEKS(year,y1st_wday,has_noleapday) \
   (((y1st_wday) ^ 4 && ((y1st_wday) ^ 3 || (has_noleapday))) ? 52 : 53)
 
+/* The number of years in which week days and leap days of the Gregorian
+   calendar are repeated  */
+#define YEAR_CYCLE 400
+
+/* Expand the number of ISO 8601 weeks in a year, or 10 or 100 years since
+   YEAR into elements of a table by the preprocessor  */
+#define YEAR_1ST_WDAY(year) \
+  WEEKDAY_FROM (UNIXEPOCH_WEEKDAY, EPOCH_DAYS (year, 0))
+#define YEAR_WEEKS(year) \
+  ISO8601_WEEKS (year, YEAR_1ST_WDAY (year), HAS_NOLEAPDAY (year))
+#define YEAR_WEEKS_10YEARS(year) \
+  YEAR_WEEKS (year), YEAR_WEEKS ((year) + 1), YEAR_WEEKS ((year) + 2), \
+  YEAR_WEEKS ((year) + 3), YEAR_WEEKS ((year) + 4), YEAR_WEEKS ((year) + 5), \
+  YEAR_WEEKS ((year) + 6), YEAR_WEEKS ((year) + 7), YEAR_WEEKS ((year) + 8), \
+  YEAR_WEEKS ((year) + 9)
+#define YEAR_WEEKS_100YEARS(year) \
+  YEAR_WEEKS_10YEARS (year), YEAR_WEEKS_10YEARS ((year) + 10), \
+  YEAR_WEEKS_10YEARS ((year) + 20), YEAR_WEEKS_10YEARS ((year) + 30), \
+  YEAR_WEEKS_10YEARS ((year) + 40), YEAR_WEEKS_10YEARS ((year) + 50), \
+  YEAR_WEEKS_10YEARS ((year) + 60), YEAR_WEEKS_10YEARS ((year) + 70), \
+  YEAR_WEEKS_10YEARS ((year) + 80), YEAR_WEEKS_10YEARS ((year) + 90)
+
+/* The number of ISO 8601 weeks in years from 2000 to 2399, indexed by
+   the remainder of dividing a year by YEAR_CYCLE  */
+static const signed char year_weeks[YEAR_CYCLE] =
+{
+  YEAR_WEEKS_100YEARS (2000),
+  YEAR_WEEKS_100YEARS (2100),
+  YEAR_WEEKS_100YEARS (2200),
+  YEAR_WEEKS_100YEARS (2300)
+};
+
+/* Return the number of ISO 8601 weeks in the specified year.  */
+static inline int
+iso8601_weeks (int64_t year)
+{
+  int r = year % YEAR_CYCLE;
+  return year_weeks[r < 0 ? r + YEAR_CYCLE : r];
+}
+
 /* Return the week number for the specified day in *YEAR.  */
 static int
-weeknumber (int *year, int yday, int wday, bool iso8601)
+weeknumber (int64_t *year, int yday, int wday, bool iso8601)
 {
   int weeknum = 1;
 
@@ -50,32 +91,16 @@ weeknumber (int *year, int yday, int wday, bool iso8601)
     return 0;
   else if (iso8601)
     {
-      int y1st_wday = WEEKDAY_FROM (wday, - yday);  /* Weed day of 1 Jan */
       int w = (11 + yday - ISO8601_WEEKDAY (wday)) / 7;
       if (w < 1)
         {
-          if (*year <= INT_MIN)
-            return 0;
-
-          int last_year = *year - 1;
-          bool has_noleapday = HAS_NOLEAPDAY (last_year);
-          int last_ydays = has_noleapday ? DAYS_IN_YEAR : DAYS_IN_LEAPYEAR;
-
-          /* Calculate the number of weeks in the last year if the specified
+          /* Set the number of weeks in the last year if the specified
              day is not included in the first week. */
-          weeknum = ISO8601_WEEKS (last_year,
-                      WEEKDAY_FROM ((y1st_wday + 6) % 7, 1 - last_ydays),
-                      has_noleapday);
-          *year = last_year;
-        }
-      else if (w > ISO8601_WEEKS (*year, y1st_wday, HAS_NOLEAPDAY (*year)))
-        {
-          if (*year < INT_MAX)
-            (*year)++;
-          else
-            /* Return the maximum week number 53 + 1 if overflow. */
-            weeknum = 54;
+          weeknum = iso8601_weeks (*year - 1);
+          (*year)--;
         }
+      else if (w > iso8601_weeks (*year))
+        (*year)++;
       else
         weeknum = w;
     }
@@ -101,7 +126,7 @@ struct era_prop
 };
 
 /* Properties of japanese era  */
-static struct era_prop jera_props[] =
+static const struct era_prop jera_props[] =
 {
   { 'M', 6, 1873,   0, 1912, 210 },
   { 'T', 1, 1912, 211, 1926, 357 },
@@ -111,43 +136,84 @@ static struct era_prop jera_props[] =
   { 0 }
 };
 
+/* The first year of japanese era and the last year in which an era
+   starts  */
+#define JERA_FIRST_YEAR 1873
+#define JERA_LAST_YEAR  2019
+
+/* Return the index of japanese era in effect on 1 Jan in YEAR, which is
+   advanced by each era in jera_props starting after 1 Jan in the year
+   before YEAR  */
+#define JERA_INDEX(year) \
+  (((year) > 1912) + ((year) > 1926) + ((year) > 1989) + ((year) > 2019))
+
+/* Expand indexes of japanese era for 10 years since YEAR into elements
+   of a table by the preprocessor  */
+#define JERA_INDEX_10YEARS(year) \
+  JERA_INDEX (year), JERA_INDEX ((year) + 1), JERA_INDEX ((year) + 2), \
+  JERA_INDEX ((year) + 3), JERA_INDEX ((year) + 4), JERA_INDEX ((year) + 5), \
+  JERA_INDEX ((year) + 6), JERA_INDEX ((year) + 7), JERA_INDEX ((year) + 8), \
+  JERA_INDEX ((year) + 9)
+
+/* Indexes of japanese era in effect on 1 Jan for each year from
+   JERA_FIRST_YEAR to JERA_LAST_YEAR  */
+static const signed char jera_indexes[JERA_LAST_YEAR - JERA_FIRST_YEAR + 1] =
+{
+  JERA_INDEX_10YEARS (1873), JERA_INDEX_10YEARS (1883),
+  JERA_INDEX_10YEARS (1893), JERA_INDEX_10YEARS (1903),
+  JERA_INDEX_10YEARS (1913), JERA_INDEX_10YEARS (1923),
+  JERA_INDEX_10YEARS (1933), JERA_INDEX_10YEARS (1943),
+  JERA_INDEX_10YEARS (1953), JERA_INDEX_10YEARS (1963),
+  JERA_INDEX_10YEARS (1973), JERA_INDEX_10YEARS (1983),
+  JERA_INDEX_10YEARS (1993), JERA_INDEX_10YEARS (2003),
+  JERA_INDEX (2013), JERA_INDEX (2014), JERA_INDEX (2015), JERA_INDEX (2016),
+  JERA_INDEX (2017), JERA_INDEX (2018), JERA_INDEX (2019)
+};
+
 /* Return a symbol character for the japanese era in YEAR and YDAY.  */
 static int
-japanese_era (int *year, int *yday)
+japanese_era (int64_t *year, int *yday)
 {
-  struct era_prop *jera_prop = jera_props;
-  if (jera_prop->from_year <= *year)
-    {
-      while (jera_prop->symbol)
-        {
-          if ((jera_prop->from_year == *year && jera_prop->from_yday <= *yday)
-              || (jera_prop->from_year < *year && jera_prop->to_year > *year)
-              || (jera_prop->to_year == *year && jera_prop->to_yday >= *yday))
-            {
-              if (jera_prop->from_year == *year)
-                *yday -= jera_prop->from_yday;
-              *year -= jera_prop->from_year - jera_prop->start_number;
+  const struct era_prop *jera_prop;
 
-              return jera_prop->symbol;
-            }
+  if (*year < JERA_FIRST_YEAR)
+    return 0;
+  else if (*year > JERA_LAST_YEAR)
+    {
+      /* Use the last era for all years after it starts. */
+      jera_prop = jera_props
+                  + sizeof jera_props / sizeof jera_props[0] - 2;
+    }
+  else
+    {
+      jera_prop = jera_props + jera_indexes[*year - JERA_FIRST_YEAR];
 
-          jera_prop++;
-        }
+      /* Change to the next era if it starts after 1 Jan in YEAR. */
+      if (jera_prop[1].symbol && jera_prop[1].from_year == *year
+          && jera_prop[1].from_yday <= *yday)
+        jera_prop++;
     }
 
-  return 0;
+  if (jera_prop->to_year < *year
+      || (jera_prop->to_year == *year && jera_prop->to_yday < *yday))
+    return 0;
+  else if (jera_prop->from_year == *year)
+    *yday -= jera_prop->from_yday;
+  *year -= jera_prop->from_year - jera_prop->start_number;
+
+  return jera_prop->symbol;
 }
 
 /* Output a parameter of date to standard output.  */
 static int
-printdate (int value, int width, int delim)
+printdate (int64_t value, int width, int delim)
 {
-  char format[] = "%01d";
+  char format[] = "%01" PRId64;
 
   if (value < 0 && width == 2)
     {
       /* Change the delimiter to '+' if negative value. */
-      value = value > INT_MIN ? - value : INT_MAX;
+      value = - value;
       delim = '+';
     }
 
@@ -193,7 +259,7 @@ printtm (const struct tm_fmt *tm_fmt, const struct tm_ptrs *tm_ptrs)
   /* Output the date, calculated from the year, month, and day. */
   if (tm_ptrs->dates)
     {
-      int year = *tm_ptrs->dates[0];
+      int64_t year = *tm_ptrs->dates[0];
       int year_width = year < 0 ? 5 : 4;
       int date_delim = '-';
       int weeknum = -1;
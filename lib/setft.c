@@ -47,14 +47,37 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "adjusttm.h"
 #include "ft.h"
 #include "ftsec.h"
 #include "imaxoverflow.h"
 #include "intoverflow.h"
+#include "timeutils.h"
 #include "wintm.h"
 
 #define EPOCH_YEAR 1970
 
+/* The range of seconds since 1970-01-01 00:00 UTC, in which relative
+   hours, minutes, and seconds are added to the start time directly
+   because its conversion to local time and back never fails, as far as
+   1 day inside the range of time_t in MSVCRT or FILETIME in Windows, or
+   about a billion years in GNU C Library  */
+#ifdef USE_TM_GLIBC
+# define RELTIME_SECONDS_MAX ((intmax_t) 1 << 55)
+# define RELTIME_SECONDS_MIN (- RELTIME_SECONDS_MAX)
+#elif defined USE_TM_MSVCRT
+# define RELTIME_SECONDS_MAX ((intmax_t) 32535215999 - 24 * 60 * 60)
+# define RELTIME_SECONDS_MIN (24 * 60 * 60)
+#else
+# define RELTIME_SECONDS_MAX (FT_SECONDS_MAX - 24 * 60 * 60)
+# define RELTIME_SECONDS_MIN (FT_SECONDS_MIN + 24 * 60 * 60)
+#endif
+
+/* The distance before and after the time calculated by adding days, in
+   which the UTC offset of time zone must not be changed, which
+   is longer than any change by a transition  */
+#define RELDATE_NOTRANS_SECONDS (26 * 60 * 60)
+
 /* If *TM0 is the old and *TM1 is the new value of a struct tm after
    passing it to mktime_z, return true if it's OK.  It's not OK if
    mktime failed or if *TM0 has out-of-range mainline members.
@@ -75,6 +98,107 @@ mktime_ok (TM const *tm0, TM const *tm1)
             | (tm0->tm_year ^ tm1->tm_year));
 }
 
+/* Initialize the specified context for the calculation of file time, in
+   which trans_isdst is 1, current time is gotten from FT_CLOCK_PRECISE,
+   and the sequence of pseudo-random values is generated for SEED, or
+   current time if SEED is less than 0.  */
+
+void
+initftcontext (FT_CONTEXT *ft_ctx, int seed)
+{
+  ft_ctx->trans_isdst = 1;
+  ft_ctx->clock = FT_CLOCK_PRECISE;
+  ft_ctx->frozen_captured = false;
+  srandsecr (&ft_ctx->rand, seed);
+}
+
+/* Modify the specified value of seconds and nanoseconds according to
+   MODFLAG by the state of pseudo-random values in *FT_CTX, or a process
+   if FT_CTX is NULL.  */
+static bool
+modifysecctx (intmax_t *seconds, int *nsec, int modflag, FT_CONTEXT *ft_ctx)
+{
+  if (ft_ctx)
+    return modifysecr (seconds, nsec, modflag, &ft_ctx->rand);
+
+  return modifysec (seconds, nsec, modflag);
+}
+
+/* Add relative hours, minutes, seconds, and nanoseconds in *FT_CHG to the
+   specified seconds and nanoseconds, and set its value changed by the
+   modflag member in the context of *FT_CTX into *FT.  On hosts that
+   support leap seconds, ignore the possibility of leap seconds; e.g.,
+   "+ 10 minutes" adds 600 seconds, even if one of them is a leap second.
+   Return true if not overflow, otherwise, false.  */
+static bool
+addreltime (FT *ft, intmax_t Start, int Start_ns, const FT_CHANGE *ft_chg,
+            FT_CONTEXT *ft_ctx)
+{
+  intmax_t orig_ns = Start_ns;
+  intmax_t sum_ns = orig_ns + ft_chg->rel_ns;
+  int normalized_ns =
+        (sum_ns % FT_NSEC_PRECISION + FT_NSEC_PRECISION) % FT_NSEC_PRECISION;
+  int d4 = (sum_ns - normalized_ns) / FT_NSEC_PRECISION;
+  intmax_t d1, t1, d2, t2, t3, t4;
+  if (IMAX_MULTIPLY_WRAPV (ft_chg->rel_hour, 60 * 60, &d1)
+      || IMAX_ADD_WRAPV (Start, d1, &t1)
+      || IMAX_MULTIPLY_WRAPV (ft_chg->rel_minutes, 60, &d2)
+      || IMAX_ADD_WRAPV (t1, d2, &t2)
+      || IMAX_ADD_WRAPV (t2, ft_chg->rel_seconds, &t3)
+      || IMAX_ADD_WRAPV (t3, d4, &t4)
+      || (ft_chg->modflag
+          && ! modifysecctx (&t4, &normalized_ns, ft_chg->modflag, ft_ctx)))
+    return false;
+
+  return sec2ft (t4, normalized_ns, ft);
+}
+
+/* Convert the specified date and the time in *TM0 into seconds since
+   1970-01-01 00:00 UTC by adding days to the date directly with the UTC
+   offset in *TM, if no transition occurs in RELDATE_NOTRANS_SECONDS
+   before and after it in the time zone of *TZ, which has the same offset
+   and the DST flag of *TM0 unless negative, and set its value into
+   *SECONDS and the parameters of its local time into *TM. Otherwise, the
+   time may be skipped over or repeated, or adjusted by DST offset, so
+   that mktime must be called. TM0 may be the same as TM. Return true if
+   converted, otherwise, false and don't overwrite *TM.  */
+static bool
+adddays (const TZ_HANDLE *tz, TM *tm, TM const *tm0,
+            int year, int month, int day, intmax_t *seconds)
+{
+  struct dtm64 date = (struct dtm64) { .tm_mday = day, .tm_mon = month,
+                                       .tm_year = year };
+  int64_t days = adjustday64 (&date);
+  int daysec = adjustdaysec (&date, &days,
+                             days * SECONDS_IN_DAY
+                             + SECONDS_AT ((int64_t) tm0->tm_hour,
+                                           tm0->tm_min, tm0->tm_sec));
+  intmax_t t = days * SECONDS_IN_DAY + daysec - tm->tm_gmtoff;
+  long int utoff;
+  int isdst;
+
+  if (date.tm_year < INT_MIN || date.tm_year > INT_MAX
+      || secoverflow (t, 0)
+      || ! tz_fixedtype (tz, t - RELDATE_NOTRANS_SECONDS,
+                         t + RELDATE_NOTRANS_SECONDS, &utoff, &isdst)
+      || utoff != tm->tm_gmtoff
+      || (tm0->tm_isdst >= 0 && isdst != tm0->tm_isdst))
+    return false;
+
+  tm->tm_year = date.tm_year;
+  tm->tm_mon = date.tm_mon;
+  tm->tm_mday = date.tm_mday;
+  tm->tm_hour = daysec / 3600;
+  tm->tm_min = daysec / 60 % 60;
+  tm->tm_sec = daysec % 60;
+  tm->tm_wday = date.tm_wday;
+  tm->tm_yday = date.tm_yday;
+  tm->tm_isdst = isdst;
+  *seconds = t;
+
+  return true;
+}
+
 /* Calculate file time for *NOW by members in *TM_CHG and set its value
    into *FT. If the datetime_unset member is true, don't calculate and copy
    *NOW changed by the modflag member to *FT. Return true if not overflow,
@@ -83,6 +207,41 @@ mktime_ok (TM const *tm0, TM const *tm1)
 bool
 calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
 {
+  return calcftctx (ft, now, ft_chg, NULL);
+}
+
+/* Calculate file time for *NOW by members in *TM_CHG in the specified
+   context, as with calcft function. If FT_CTX is NULL, use the context of
+   a process. Return true if not overflow, otherwise, false.  */
+
+bool
+calcftctx (FT *ft, const FT *now, const FT_CHANGE *ft_chg, FT_CONTEXT *ft_ctx)
+{
+  return calcft_z (NULL, ft, now, ft_chg, ft_ctx);
+}
+
+/* Convert the specified parameters of time in the time zone of *TZ, or
+   local time zone by TRANS_ISDST if TZ is NULL, into seconds since
+   1970-01-01 00:00 UTC.  */
+static intmax_t
+mktimetz (const TZ_HANDLE *tz, TM *tm, int trans_isdst)
+{
+  if (tz)
+    return mktimew_z (tz, tm);
+
+  return mktimewtrans (tm, trans_isdst);
+}
+
+/* Calculate file time for *NOW by members in *TM_CHG in the specified
+   context and the time zone of *TZ instead of local time zone, as with
+   calcftctx function. If TZ is NULL, use local time zone. Return true if
+   not overflow, otherwise, false.  */
+
+bool
+calcft_z (const TZ_HANDLE *tz, FT *ft, const FT *now, const FT_CHANGE *ft_chg,
+          FT_CONTEXT *ft_ctx)
+{
+  int trans_isdst = ft_ctx ? ft_ctx->trans_isdst : 1;
   intmax_t Start;
   int Start_ns;
 
@@ -92,7 +251,7 @@ calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
     {
       if (ft_chg->modflag)
         {
-          if (! modifysec (&Start, &Start_ns, ft_chg->modflag))
+          if (! modifysecctx (&Start, &Start_ns, ft_chg->modflag, ft_ctx))
             return false;
 
           sec2ft (Start, Start_ns, ft);
@@ -105,12 +264,22 @@ calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
   else if (ft_chg->ns >= 0)
     Start_ns = ft_chg->ns;
 
+  /* If only relative hours, minutes, and seconds are specified, add them
+     to the start time without the conversion to local time and back,
+     by which it's never changed.  */
+  if (ft_chg->rel_set && ! ft_chg->date_set && ! ft_chg->tz_set
+      && ft_chg->hour < 0 && ft_chg->day_number < 0
+      && ft_chg->lctz_isdst < 0
+      && ! (ft_chg->rel_year | ft_chg->rel_month | ft_chg->rel_day)
+      && Start >= RELTIME_SECONDS_MIN && Start <= RELTIME_SECONDS_MAX)
+    return addreltime (ft, Start, Start_ns, ft_chg, ft_ctx);
+
   /* Never use the environment variable of a time zone ('TZ="XXX"').  */
 
   TM tm;
   TM tm0;
 
-  if (! localtimew (&Start, &tm))
+  if (! (tz ? localtimew_z (tz, &Start, &tm) : localtimew (&Start, &tm)))
     return false;
 
   if (ft_chg->date_set)
@@ -150,7 +319,7 @@ calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
   tm0.tm_isdst = tm.tm_isdst;
   tm.tm_wday = -1;
 
-  Start = mktimew (&tm);
+  Start = mktimetz (tz, &tm, trans_isdst);
 
   if (! mktime_ok (&tm0, &tm))
     {
@@ -190,7 +359,7 @@ calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
           tm.tm_year = tm0.tm_year;
           tm.tm_isdst = tm0.tm_isdst;
           tm.tm_wday = -1;
-          Start = mktimew (&tm);
+          Start = mktimetz (tz, &tm, trans_isdst);
           repaired = mktime_ok (&tm0, &tm);
         }
 
@@ -212,8 +381,12 @@ calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
              || dayincr < INT_MIN || dayincr > INT_MAX
              || INT_ADD_WRAPV (dayincr, tm.tm_mday, &tm.tm_mday)))
         {
+          /* Shift the epoch day by DAYINCR and look up the time zone only
+             once for the result if its handle is specified.  */
           tm.tm_isdst = -1;
-          Start = mktimew (&tm);
+          if (! tz || ! adddays (tz, &tm, &tm, tm.tm_year, tm.tm_mon,
+                                 tm.tm_mday, &Start))
+            Start = mktimetz (tz, &tm, trans_isdst);
         }
 
       if (tm.tm_yday < 0)
@@ -228,17 +401,22 @@ calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
           || INT_ADD_WRAPV (tm.tm_mon, ft_chg->rel_month, &month)
           || INT_ADD_WRAPV (tm.tm_mday, ft_chg->rel_day, &day))
         return false;
-      tm.tm_year = year;
-      tm.tm_mon = month;
-      tm.tm_mday = day;
-      tm.tm_hour = tm0.tm_hour;
-      tm.tm_min = tm0.tm_min;
-      tm.tm_sec = tm0.tm_sec;
-      tm.tm_isdst = tm0.tm_isdst;
-      tm.tm_wday = -1;
-      Start = mktimew (&tm);
-      if (tm.tm_wday < 0)
-        return false;
+      /* Transitions of local time zone are not known without conversions
+         to local time, which cost more than mktime.  */
+      else if (! tz || ! adddays (tz, &tm, &tm0, year, month, day, &Start))
+        {
+          tm.tm_year = year;
+          tm.tm_mon = month;
+          tm.tm_mday = day;
+          tm.tm_hour = tm0.tm_hour;
+          tm.tm_min = tm0.tm_min;
+          tm.tm_sec = tm0.tm_sec;
+          tm.tm_isdst = tm0.tm_isdst;
+          tm.tm_wday = -1;
+          Start = mktimetz (tz, &tm, trans_isdst);
+          if (tm.tm_wday < 0)
+            return false;
+        }
     }
 
   if (ft_chg->tz_set)
@@ -254,30 +432,12 @@ calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
       Start = t1;
     }
 
-  /* Add relative hours, minutes, and seconds.  On hosts that support
-     leap seconds, ignore the possibility of leap seconds; e.g.,
-     "+ 10 minutes" adds 600 seconds, even if one of them is a
-     leap second.  Typically this is not what the user wants, but it's
-     too hard to do it the other way, because the time zone indicator
-     must be applied before relative times, and if mktime is applied
-     again the time zone will be lost.  */
-  intmax_t orig_ns = Start_ns;
-  intmax_t sum_ns = orig_ns + ft_chg->rel_ns;
-  int normalized_ns =
-        (sum_ns % FT_NSEC_PRECISION + FT_NSEC_PRECISION) % FT_NSEC_PRECISION;
-  int d4 = (sum_ns - normalized_ns) / FT_NSEC_PRECISION;
-  intmax_t d1, t1, d2, t2, t3, t4;
-  if (IMAX_MULTIPLY_WRAPV (ft_chg->rel_hour, 60 * 60, &d1)
-      || IMAX_ADD_WRAPV (Start, d1, &t1)
-      || IMAX_MULTIPLY_WRAPV (ft_chg->rel_minutes, 60, &d2)
-      || IMAX_ADD_WRAPV (t1, d2, &t2)
-      || IMAX_ADD_WRAPV (t2, ft_chg->rel_seconds, &t3)
-      || IMAX_ADD_WRAPV (t3, d4, &t4)
-      || (ft_chg->modflag
-          && ! modifysec (&t4, &normalized_ns, ft_chg->modflag)))
-    return false;
-
-  return sec2ft (t4, normalized_ns, ft);
+  /* Add relative hours, minutes, and seconds.  Typically ignoring leap
+     seconds is not what the user wants, but it's too hard to do it the
+     other way, because the time zone indicator must be applied before
+     relative times, and if mktime is applied again the time zone will be
+     lost.  */
+  return addreltime (ft, Start, Start_ns, ft_chg, ft_ctx);
 }
 
 /* Change the specified file time by members in *TM_CHG and set its value
@@ -288,6 +448,18 @@ calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg)
 bool
 setft (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
        const FT_CHANGE *ft_chg)
+{
+  return setftctx (ft_file, ft_nowp, ft_chg, NULL);
+}
+
+/* Change the specified file time by members in *TM_CHG in the specified
+   context and set its value to the file specified by *FT_FILE, as with
+   setft function. If FT_CTX is NULL, use the context of a process. Return
+   true if successfull, otherwise, false.  */
+
+bool
+setftctx (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
+          const FT_CHANGE *ft_chg, FT_CONTEXT *ft_ctx)
 {
   if (! IS_INVALID_FILE (ft_file, false))
     {
@@ -295,13 +467,13 @@ setft (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
       FT ft[FT_SIZE];
       int i;
 
-      for (i = 0; i < FT_SIZE; i++)
+      for (i = 0; i < FT_SETTABLE_SIZE; i++)
         {
           if (ft_nowp[i])
             {
               if (ft_chg)
                 {
-                  if (! calcft (ft + i, ft_nowp[i], ft_chg))
+                  if (! calcftctx (ft + i, ft_nowp[i], ft_chg, ft_ctx))
                     return false;
 
 #ifndef USE_TM_GLIBC
@@ -343,6 +515,7 @@ setft (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
 }
 
 #ifdef TEST
+# include <errno.h>
 # include <stdio.h>
 # include <unistd.h>
 
@@ -356,8 +529,6 @@ setft (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
 #  include "fd-reopen.h"
 # endif
 
-int trans_isdst = 1;
-
 char *program_name = "setft";
 
 static void
@@ -405,12 +576,14 @@ Options:\n"
   -r FILE   use FILE's timestamp instead of current time\n"
 # ifdef USE_TM_GLIBC
 "\
-  -v        output time " IN_FILETIME
+  -v        output time " IN_FILETIME "\n"
 # else
 "\
-  -s        output time " IN_UNIX_SECONDS
+  -s        output time " IN_UNIX_SECONDS "\n"
 # endif
-"\n", stdout);
+"\
+  -Z ZONE   calculate time in the time zone of ZONE if FILE is \"-\",\n\
+            which is the name of TZif file or POSIX TZ string\n", stdout);
   exit (status);
 }
 
@@ -481,6 +654,8 @@ main (int argc, char **argv)
     (FT_CHANGE) { .datetime_unset = false, .date_set = false, .year = -1,
                   .hour = -1, .minutes = -1, .seconds = -1, .ns = -1,
                   .day_number = -1, .tz_set = false, .lctz_isdst = -1 };
+  FT_CONTEXT ft_ctx = (FT_CONTEXT) { .trans_isdst = 1 };
+  TZ_HANDLE *tz = NULL;
   intmax_t ft_elapse = 0;
   int ft_frac_val = -1;
   int ftind = -1;
@@ -503,7 +678,7 @@ main (int argc, char **argv)
     error (EXIT_FAILURE, ERRNO (), "failed to get command arguments");
 # endif
 
-  while ((c = getopt (argc, argv, ":abCFhmPr:R:svT")) != -1)
+  while ((c = getopt (argc, argv, ":abCFhmPr:R:svZ:T")) != -1)
     {
       switch (c)
         {
@@ -554,9 +729,14 @@ main (int argc, char **argv)
           INIT_FILE (ref_file, wargv[optind - 1], false);
 # endif
           break;
+        case 'Z':
+          tz = tz_open (optarg);
+          if (! tz)
+            error (EXIT_FAILURE, errno, "invalid time zone '%s'", optarg);
+          break;
 # ifdef USE_TM_SELFIMPL
         case 'T':
-          trans_isdst = 0;
+          ft_ctx.trans_isdst = 0;
           break;
 # endif
         default:
@@ -668,7 +848,7 @@ main (int argc, char **argv)
 
   /* Generate a new sequence at once before get random values. */
   if (IS_FT_NSEC_RANDOMIZING (ft_chg.modflag))
-    srandsec (--seed);
+    srandsecr (&ft_ctx.rand, --seed);
 
   /* Change the file time for the file of the specified name by parameters
      gotten from arguments or output its value elapsed since a time. */
@@ -686,11 +866,11 @@ main (int argc, char **argv)
         if (IS_INVALID_FILE (&ft_file, false))
           errfile (EXIT_FAILURE, ERRNO (), "failed to open", &ft_file);
 
-      success = setft (&ft_file, ft_nowp, &ft_chg);
+      success = setftctx (&ft_file, ft_nowp, &ft_chg, &ft_ctx);
     }
   else  /* ft_file.name == NULL */
     {
-      success = calcft (ft, now + ftind, &ft_chg);
+      success = calcft_z (tz, ft, now + ftind, &ft_chg, &ft_ctx);
 
       if (success)
         {
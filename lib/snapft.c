@@ -0,0 +1,502 @@
+/* Save file times into the snapshot and restore them
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#include "config.h"
+
+#ifdef USE_TM_GLIBC
+# include <fcntl.h>
+# include <time.h>
+#else
+# ifndef UNICODE
+#  define UNICODE
+# endif
+# include <windows.h>
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ft.h"
+#include "ftsec.h"
+#include "snapft.h"
+
+/* The multiplier from nanoseconds in file time to the value saved in
+   the snapshot  */
+#define SNAPFT_NSEC_SCALE (1000000000 / FT_NSEC_PRECISION)
+
+/* The maximum length of a file name saved in the snapshot  */
+#define SNAPFT_NAME_MAX 0x100000
+
+/* Return the size of padding after a file name of LEN bytes.  */
+#define SNAPFT_NAME_PAD(len) ((8 - (len) % 8) % 8)
+
+/* Write the magic number and version of the snapshot into STREAM. Return
+   true if successfull, otherwise, false.  */
+
+bool
+putsnapfthead (FILE *stream)
+{
+  return fwrite (SNAPFT_MAGIC SNAPFT_VERSION,
+                 SNAPFT_MAGIC_SIZE, 1, stream) == 1;
+}
+
+/* Read the magic number and version of the snapshot from STREAM. Return
+   true if those are valid, otherwise, false.  */
+
+bool
+getsnapfthead (FILE *stream)
+{
+  char magic[SNAPFT_MAGIC_SIZE];
+
+  return fread (magic, SNAPFT_MAGIC_SIZE, 1, stream) == 1
+         && memcmp (magic, SNAPFT_MAGIC SNAPFT_VERSION,
+                    SNAPFT_MAGIC_SIZE) == 0;
+}
+
+/* Write the record of the specified file name, file times, and flag of
+   a directory into STREAM. If the nanoseconds of a time is UTIME_OMIT on
+   GNU/Linux, don't save its time. Return true if successfull, otherwise,
+   false.  */
+
+bool
+putsnapft (FILE *stream, const char *name, const FT ft[FT_SIZE], bool isdir)
+{
+  static const char pad[8] = { 0 };
+  struct snapft_record rec;
+  size_t len = strlen (name);
+  int i;
+
+  if (len > SNAPFT_NAME_MAX)
+    return false;
+
+  for (i = 0; i < SNAPFT_TIME_SIZE; i++)
+    {
+      intmax_t seconds;
+      int nsec;
+
+      rec.seconds[i] = 0;
+      rec.nsec[i] = -1;
+
+      if (i < FT_SIZE
+#ifdef USE_TM_GLIBC
+          && ft[i].tv_nsec != UTIME_OMIT
+#endif
+          && ft2sec (ft + i, &seconds, &nsec))
+        {
+          rec.seconds[i] = seconds;
+          rec.nsec[i] = nsec * SNAPFT_NSEC_SCALE;
+        }
+    }
+
+  rec.name_len = len;
+  rec.flags = isdir ? SNAPFT_ISDIR : 0;
+  rec.reserved = 0;
+
+  return fwrite (&rec, sizeof rec, 1, stream) == 1
+         && fwrite (name, 1, len, stream) == len
+         && fwrite (pad, 1, SNAPFT_NAME_PAD (len), stream)
+            == SNAPFT_NAME_PAD (len);
+}
+
+/* Read the record of file times from STREAM and set the file name into
+   the array pointed to *NAME, reallocated if its size *NAME_ALLOC is not
+   enough, and each time into FT, setting the bit of gotten times into
+   *FT_MASK and the flag of a directory into *ISDIR. Return 1 if read,
+   0 if reached the end of STREAM, otherwise, -1.  */
+
+int
+getsnapft (FILE *stream, char **name, size_t *name_alloc,
+           FT ft[FT_SIZE], int *ft_mask, bool *isdir)
+{
+  struct snapft_record rec;
+  char pad[8];
+  int i;
+
+  if (fread (&rec, sizeof rec, 1, stream) != 1)
+    return feof (stream) ? 0 : -1;
+  else if (rec.name_len > SNAPFT_NAME_MAX)
+    return -1;
+
+  if (rec.name_len + 1 > *name_alloc)
+    {
+      char *p = realloc (*name, rec.name_len + 1);
+      if (! p)
+        return -1;
+
+      *name = p;
+      *name_alloc = rec.name_len + 1;
+    }
+
+  if (fread (*name, 1, rec.name_len, stream) != rec.name_len
+      || fread (pad, 1, SNAPFT_NAME_PAD (rec.name_len), stream)
+         != SNAPFT_NAME_PAD (rec.name_len))
+    return -1;
+
+  (*name)[rec.name_len] = '\0';
+  *ft_mask = 0;
+  *isdir = rec.flags & SNAPFT_ISDIR;
+
+  for (i = 0; i < FT_SIZE; i++)
+    {
+      if (rec.nsec[i] >= 0)
+        {
+          if (! sec2ft (rec.seconds[i], rec.nsec[i] / SNAPFT_NSEC_SCALE,
+                        ft + i))
+            return -1;
+
+          *ft_mask |= 1 << i;
+        }
+    }
+
+  return 1;
+}
+
+#ifdef TEST
+# include <errno.h>
+# include <unistd.h>
+
+# include "cmdtmio.h"
+# include "errft.h"
+# include "error.h"
+# include "exit.h"
+
+char *program_name = "snapft";
+
+static void
+usage (int status)
+{
+  printusage ("snapft", " SNAPSHOT [FILE]...\n\
+Save times of each FILE and all files under it if a directory into\n\
+SNAPSHOT, or restore times of files saved in SNAPSHOT by -r.\n\
+\n\
+Options:\n\
+  -r   restore times of files in the order saved into SNAPSHOT"
+, true, false, 0);
+  exit (status);
+}
+
+# ifdef USE_TM_GLIBC
+typedef char NAMECHAR;
+#  define PATH_SEPARATOR '/'
+# else
+typedef WCHAR NAMECHAR;
+#  define PATH_SEPARATOR L'\\'
+
+LPWSTR *wargv = NULL;
+# endif
+
+/* The buffer of a path saved into the snapshot  */
+static NAMECHAR *path_buf;
+static size_t path_alloc;
+
+/* Extend the buffer of a path to the specified length. Return true if
+   successfull, otherwise, false.  */
+static bool
+extend_path (size_t len)
+{
+  if (len + 1 > path_alloc)
+    {
+      size_t alloc = path_alloc ? path_alloc * 2 : 256;
+      while (len + 1 > alloc)
+        alloc *= 2;
+
+      NAMECHAR *p = realloc (path_buf, sizeof (NAMECHAR) * alloc);
+      if (! p)
+        return false;
+
+      path_buf = p;
+      path_alloc = alloc;
+    }
+
+  return true;
+}
+
+/* Write file times of the file at PATH_BUF into STREAM. Return true if
+   successfull, otherwise, false.  */
+static bool
+putpathft (FILE *stream, const FT ft[FT_SIZE], bool isdir)
+{
+# ifdef USE_TM_GLIBC
+  return putsnapft (stream, path_buf, ft, isdir);
+# else
+  static char *name = NULL;
+  static int name_size = 0;
+  int size = WideCharToMultiByte (CP_UTF8, 0, path_buf, -1,
+                                  NULL, 0, NULL, NULL);
+
+  if (size <= 0)
+    return false;
+  else if (size > name_size)
+    {
+      char *p = realloc (name, size);
+      if (! p)
+        return false;
+
+      name = p;
+      name_size = size;
+    }
+
+  return WideCharToMultiByte (CP_UTF8, 0, path_buf, -1,
+                              name, size, NULL, NULL) > 0
+         && putsnapft (stream, name, ft, isdir);
+# endif
+}
+
+/* Write file times of all files under the directory at PATH_BUF, whose
+   length is LEN, into STREAM. Return true if successfull, otherwise,
+   false.  */
+static bool
+snapdir (FILE *stream, size_t len)
+{
+  struct file dir_file;
+  struct dirft dir_ft;
+  bool ok = true;
+  size_t sep_len = len > 0 && path_buf[len - 1] == PATH_SEPARATOR ? 0 : 1;
+  size_t i;
+
+# ifdef USE_TM_GLIBC
+  dir_file = (struct file) { .name = path_buf, .fd = -1,
+                             .no_dereference = true, .isdir = true };
+# else
+  dir_file = (struct file) { .name = path_buf,
+                             .hFile = INVALID_HANDLE_VALUE, .isdir = true };
+# endif
+
+  if (! getdirft (&dir_ft, &dir_file, 0))
+    {
+      errfile (0, ERRNO (), "failed to read directory", &dir_file);
+      return false;
+    }
+
+  for (i = 0; i < dir_ft.entry_num; i++)
+    {
+      const NAMECHAR *name = DIRFT_NAME (&dir_ft, i);
+# ifdef USE_TM_GLIBC
+      size_t name_len = strlen (name);
+# else
+      size_t name_len = wcslen (name);
+# endif
+      size_t path_len = len + sep_len + name_len;
+
+      if (! extend_path (path_len))
+        error (EXIT_FAILURE, ENOMEM, "failed to save %s", "file times");
+
+      path_buf[len] = PATH_SEPARATOR;
+      memcpy (path_buf + len + sep_len, name, sizeof (NAMECHAR) * name_len);
+      path_buf[path_len] = '\0';
+
+      if (! putpathft (stream, dir_ft.entries[i].ft, dir_ft.entries[i].isdir))
+        error (EXIT_FAILURE, ERRNO (), "failed to write snapshot");
+
+      /* Descend into a directory after its times are saved, so that the
+         snapshot is in the order of entries in each directory. */
+      if (dir_ft.entries[i].isdir)
+        ok &= snapdir (stream, path_len);
+    }
+
+  path_buf[len] = '\0';
+  freedirft (&dir_ft);
+
+  return ok;
+}
+
+/* Write file times of the specified file and all files under it if
+   a directory into STREAM. Return true if successfull, otherwise,
+   false.  */
+static bool
+snapft (FILE *stream, const NAMECHAR *file)
+{
+  struct file ft_file;
+  FT ft[FT_SIZE];
+# ifdef USE_TM_GLIBC
+  size_t len = strlen (file);
+
+  ft_file = (struct file) { .name = file, .fd = -1,
+                            .no_dereference = true, .isdir = false };
+# else
+  size_t len = wcslen (file);
+
+  ft_file = (struct file) { .name = file, .hFile = INVALID_HANDLE_VALUE,
+                            .isdir = false };
+# endif
+
+  if (! getft (ft, &ft_file))
+    {
+      errfile (0, ERRNO (), "failed to get attributes of", &ft_file);
+      return false;
+    }
+  else if (! extend_path (len))
+    error (EXIT_FAILURE, ENOMEM, "failed to save %s", "file times");
+
+  memcpy (path_buf, file, sizeof (NAMECHAR) * (len + 1));
+
+  /* Remove trailing separators except for the root directory. */
+  while (len > 1 && (path_buf[len - 1] == '/'
+                     || path_buf[len - 1] == PATH_SEPARATOR))
+    path_buf[--len] = '\0';
+
+  if (! putpathft (stream, ft, ft_file.isdir))
+    error (EXIT_FAILURE, ERRNO (), "failed to write snapshot");
+
+  return !ft_file.isdir || snapdir (stream, len);
+}
+
+/* Restore file times saved in STREAM. Return true if successfull,
+   otherwise, false.  */
+static bool
+restoreft (FILE *stream)
+{
+  char *name = NULL;
+  size_t name_alloc = 0;
+  FT ft[FT_SIZE];
+  int ft_mask;
+  int r;
+  bool isdir;
+  bool ok = true;
+
+  while ((r = getsnapft (stream, &name, &name_alloc,
+                         ft, &ft_mask, &isdir)) > 0)
+    {
+      const FT *ft_nowp[FT_SIZE];
+      struct file ft_file;
+      int i;
+
+      for (i = 0; i < FT_SIZE; i++)
+        ft_nowp[i] = ft_mask & (1 << i) ? ft + i : NULL;
+
+# ifdef USE_TM_GLIBC
+      /* Set times by the name without opening each file. */
+      ft_file = (struct file) { .name = name, .fd = -1,
+                                .no_dereference = true, .isdir = isdir };
+# else
+      int size = MultiByteToWideChar (CP_UTF8, 0, name, -1, NULL, 0);
+
+      if (size <= 0 || ! extend_path (size))
+        {
+          ok = false;
+          continue;
+        }
+
+      MultiByteToWideChar (CP_UTF8, 0, name, -1, path_buf, size);
+
+      ft_file = (struct file) { .name = path_buf,
+                                .hFile = INVALID_HANDLE_VALUE,
+                                .isdir = isdir };
+      OPEN_FILE (&ft_file, true);
+# endif
+
+      if (! setft (&ft_file, ft_nowp, NULL))
+        {
+          errfile (0, ERRNO (), "setting times of", &ft_file);
+          ok = false;
+        }
+
+# ifndef USE_TM_GLIBC
+      CloseHandle (ft_file.hFile);
+# endif
+    }
+
+  free (name);
+
+  if (r < 0)
+    error (EXIT_FAILURE, ERRNO (), "failed to read snapshot");
+
+  return ok;
+}
+
+/* The size of buffer used for the stream of the snapshot  */
+# define SNAPFT_BUFSIZE 65536
+
+int
+main (int argc, char **argv)
+{
+  FILE *stream;
+  const char *snapshot;
+  int c;
+  bool restore = false;
+  bool ok = true;
+
+  while ((c = getopt (argc, argv, ":r")) != -1)
+    {
+      switch (c)
+        {
+        case 'r':
+          restore = true;
+          break;
+        default:
+          usage (EXIT_FAILURE);
+        }
+    }
+
+  if (argc <= optind || (restore && argc - 1 > optind))
+    usage (EXIT_FAILURE);
+
+  snapshot = argv[optind];
+
+# ifndef USE_TM_GLIBC
+  int wargc;
+
+  wargv = CommandLineToArgvW (GetCommandLineW (), &wargc);
+  if (wargv == NULL || wargc < argc)
+    error (EXIT_FAILURE, ERRNO (), "failed to get command arguments");
+
+  stream = _wfopen (wargv[optind], restore ? L"rb" : L"wb");
+# else
+  stream = fopen (snapshot, restore ? "rb" : "wb");
+# endif
+
+  if (! stream)
+    error (EXIT_FAILURE, ERRNO (), "failed to open '%s'", snapshot);
+
+  setvbuf (stream, NULL, _IOFBF, SNAPFT_BUFSIZE);
+
+  if (restore)
+    {
+      if (! getsnapfthead (stream))
+        error (EXIT_FAILURE, 0, "invalid snapshot '%s'", snapshot);
+
+      ok = restoreft (stream);
+    }
+  else
+    {
+      if (! putsnapfthead (stream))
+        error (EXIT_FAILURE, ERRNO (), "failed to write snapshot");
+
+      while (++optind < argc)
+        {
+# ifdef USE_TM_GLIBC
+          ok &= snapft (stream, argv[optind]);
+# else
+          ok &= snapft (stream, wargv[optind]);
+# endif
+        }
+    }
+
+  if (fclose (stream) != 0)
+    error (EXIT_FAILURE, ERRNO (), "failed to close '%s'", snapshot);
+
+  free (path_buf);
+
+# ifndef USE_TM_GLIBC
+  LocalFree (wargv);
+# endif
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
@@ -0,0 +1,67 @@
+/* snapft.h -- Snapshot of file times saved into a file
+
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+/* The snapshot of file times begins with the magic number and version,
+   followed by records of fixed size, each of which is followed by a file
+   name encoded in UTF-8 on Windows and padded to a multiple of 8 bytes.
+   Three times are always saved for each file by seconds since 1970-01-01
+   00:00 UTC and nanoseconds, which is -1 if not gotten.  */
+
+#define SNAPFT_MAGIC      "FTSNAP"
+#define SNAPFT_VERSION    "01"
+#define SNAPFT_MAGIC_SIZE 8
+
+#define SNAPFT_TIME_SIZE  3
+
+struct snapft_record
+{
+  int64_t seconds[SNAPFT_TIME_SIZE];
+  int32_t nsec[SNAPFT_TIME_SIZE];
+  uint32_t name_len;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+#define SNAPFT_ISDIR 1  /* The file is a directory */
+
+/* Write the magic number and version of the snapshot into STREAM. Return
+   true if successfull, otherwise, false.  */
+
+bool putsnapfthead (FILE *stream);
+
+/* Read the magic number and version of the snapshot from STREAM. Return
+   true if those are valid, otherwise, false.  */
+
+bool getsnapfthead (FILE *stream);
+
+/* Write the record of the specified file name, file times, and flag of
+   a directory into STREAM. If the nanoseconds of a time is UTIME_OMIT on
+   GNU/Linux, don't save its time. Return true if successfull, otherwise,
+   false.  */
+
+bool putsnapft (FILE *stream, const char *name, const FT ft[FT_SIZE],
+                bool isdir);
+
+/* Read the record of file times from STREAM and set the file name into
+   the array pointed to *NAME, reallocated if its size *NAME_ALLOC is not
+   enough, and each time into FT, setting the bit of gotten times into
+   *FT_MASK and the flag of a directory into *ISDIR. Return 1 if read,
+   0 if reached the end of STREAM, otherwise, -1.  */
+
+int getsnapft (FILE *stream, char **name, size_t *name_alloc,
+               FT ft[FT_SIZE], int *ft_mask, bool *isdir);
@@ -0,0 +1,69 @@
+/* Split lines in the buffer and convert the first field of each line
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#include "config.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "splitlines.h"
+
+/* Split lines in BUF of SIZE bytes up to LINE_NUM and call CONVERT for the
+   first field of each line, separated by a character in SEPS, and the rest.
+   Both are terminated by the null character in place of the separator and
+   the newline, removing a carriage return before it.  Store the pointer to
+   the line not split because its newline is not included in BUF into
+   *ENDPTR.  Return the number of split lines.  */
+
+size_t
+splitlines (char *buf, size_t size, const char *seps, size_t line_num,
+            splitlines_convert convert, void *arg, char **endptr)
+{
+  char *p = buf;
+  char *end = buf + size;
+  size_t i;
+
+  for (i = 0; i < line_num; i++)
+    {
+      char *eol = memchr (p, '\n', end - p);
+      char *rest;
+      size_t len;
+
+      if (! eol)
+        break;
+
+      *eol = '\0';
+      if (eol > p && eol[-1] == '\r')
+        eol[-1] = '\0';
+
+      len = strcspn (p, seps);
+      rest = NULL;
+      if (p[len] != '\0')
+        {
+          p[len] = '\0';
+          rest = p + len + 1;
+        }
+
+      convert (p, rest, i, arg);
+
+      p = eol + 1;
+    }
+
+  *endptr = p;
+
+  return i;
+}
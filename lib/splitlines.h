@@ -0,0 +1,38 @@
+/* splitlines.h -- Split lines in the buffer
+
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef SPLITLINES_H_
+# define SPLITLINES_H_
+
+/* The function converting the first field of a line and the rest of it,
+   which is NULL if the line has no separator, into the result for the
+   line at INDEX by ARG passed to splitlines  */
+
+typedef void (*splitlines_convert) (char *field, char *rest, size_t index,
+                                    void *arg);
+
+/* Split lines in BUF of SIZE bytes up to LINE_NUM and call CONVERT for the
+   first field of each line, separated by a character in SEPS, and the rest.
+   Both are terminated by the null character in place of the separator and
+   the newline, removing a carriage return before it.  Store the pointer to
+   the line not split because its newline is not included in BUF into
+   *ENDPTR.  Return the number of split lines.  */
+
+size_t splitlines (char *buf, size_t size, const char *seps, size_t line_num,
+                   splitlines_convert convert, void *arg, char **endptr);
+#endif
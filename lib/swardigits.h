@@ -0,0 +1,92 @@
+/* swardigits.h -- Conversion of decimal digits in a 64-bit word
+
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+/* Each function reads 8 characters into a 64-bit word of which the lowest
+   byte is the first character regardless of the byte order, so that all
+   characters are checked or converted by a few arithmetic operations.
+   The caller must ensure that 8 characters can be read, except for digits
+   counted already.  */
+
+#define SWAR_ONES  0x0101010101010101ULL
+#define SWAR_ZEROS (0x30 * SWAR_ONES)  /* '0' in all bytes */
+
+/* Return 8 characters at the specified pointer as a 64-bit word.  */
+
+static inline uint64_t
+swarload (const char *p)
+{
+  const unsigned char *s = (const unsigned char *)p;
+
+  return (uint64_t) s[0] | (uint64_t) s[1] << 8 | (uint64_t) s[2] << 16
+         | (uint64_t) s[3] << 24 | (uint64_t) s[4] << 32
+         | (uint64_t) s[5] << 40 | (uint64_t) s[6] << 48
+         | (uint64_t) s[7] << 56;
+}
+
+/* Return true if all bytes in the specified word, masked by 0xff in MASK,
+   are decimal digits.  */
+
+static inline bool
+swardigits (uint64_t word, uint64_t mask)
+{
+  /* Check whether the high nibble is 3 and adding 6 to the low nibble
+     doesn't carry into the high nibble for each byte. */
+  return ((word & (0xf0 * SWAR_ONES) & mask) == (SWAR_ZEROS & mask))
+         && (((word + 0x06 * SWAR_ONES) & (0xf0 * SWAR_ONES) & mask)
+             == (SWAR_ZEROS & mask));
+}
+
+/* Return the value of 8 decimal digits in the specified word.  */
+
+static inline uint32_t
+swar8digits (uint64_t word)
+{
+  word -= SWAR_ZEROS;
+  word = (word * 10 + (word >> 8)) & 0x00ff00ff00ff00ffULL;
+  word = (word * 100 + (word >> 16)) & 0x0000ffff0000ffffULL;
+  word = (word * 10000 + (word >> 32)) & 0xffffffffULL;
+
+  return (uint32_t) word;
+}
+
+/* Return the value of 2 decimal digits at byte index I in the specified
+   word, which are checked already.  */
+
+#define SWAR_2DIGITS(word,i) \
+  ((int) (((word) >> ((i) * 8)) & 0x0f) * 10 \
+   + (int) (((word) >> ((i) * 8 + 8)) & 0x0f))
+
+/* The maximum number of decimal digits whose value never overflows
+   uint64_t  */
+#define SWAR_DIGITS_MAX 19
+
+/* Return the value of LEN decimal digits at the specified pointer, which
+   are checked already and must not be more than SWAR_DIGITS_MAX.  */
+
+static inline uint64_t
+swarndigits (const char *p, int len)
+{
+  uint64_t value = 0;
+
+  for (; len >= 8; len -= 8, p += 8)
+    value = value * 100000000 + swar8digits (swarload (p));
+  for (; len > 0; len--, p++)
+    value = value * 10 + (*p - '0');
+
+  return value;
+}
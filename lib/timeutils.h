@@ -0,0 +1,191 @@
+/* timeutils.h -- Functions exported from the library of timeutils
+
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef TIMEUTILS_H_
+# define TIMEUTILS_H_
+
+/* The version of functions exported from the library, which is changed
+   only if their interface is changed  */
+
+# define TIMEUTILS_VERSION 1
+
+/* The library except for Windows is built to use POSIX functions in GNU C
+   Library, whose file time is struct timespec  */
+
+# if ! defined _WIN32 && ! defined USE_TM_GLIBC
+#  define USE_TM_GLIBC
+# endif
+
+/* File time is struct timespec declared by <time.h> only if POSIX.1-2008
+   is requested, which is done here for the strict C99 or C11 mode with
+   -std=c99 or -std=c11, unless another feature is selected by the includer
+   or <time.h> has been included before this file.  */
+
+# if defined USE_TM_GLIBC && ! defined _POSIX_C_SOURCE \
+     && ! defined _XOPEN_SOURCE && ! defined _GNU_SOURCE \
+     && ! defined _DEFAULT_SOURCE
+#  define _POSIX_C_SOURCE 200809L
+# endif
+
+# ifdef USE_TM_GLIBC
+#  include <time.h>
+# else
+#  include <windows.h>
+# endif
+# include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+
+# include "ft.h"
+# include "wintm.h"
+
+/* The attribute of functions exported from the shared library, which is
+   built with -fvisibility=hidden  */
+
+# if ((defined __GNUC__ && __GNUC__ >= 4) || defined __clang__) \
+     && ! defined _WIN32 && ! defined __CYGWIN__
+#  define TIMEUTILS_API __attribute__ ((visibility ("default")))
+# else
+#  define TIMEUTILS_API
+# endif
+
+/* Functions are thread-safe except for the following. parseft keeps all
+   state of parsing on the stack. calcft and setft share the sequence of
+   pseudo-random values in a process if FT_NSEC_RANDOM or FT_NSEC_PERMUTE
+   is set into the modflag member, so that calcftctx and setftctx must be
+   called by each thread with its own FT_CONTEXT instead, which also keeps
+   the clock of current time selected by selectftclock and the time
+   captured for FT_CLOCK_FROZEN. loadtzabbrs, which builds the index
+   shared read-only by parseft, must be called before threads are
+   started.  */
+
+/* Parse the specified string as parameters of setting file time and set
+   those values into *FT_PARSING. Return true if parsing is completed,
+   otherwise, false.  */
+
+TIMEUTILS_API bool parseft (FT_PARSING *ft_parsing, const char *str);
+
+/* Load abbreviations of time zones from TZif files under DIR, or TZDIR or
+   "/usr/share/zoneinfo" if NULL, into the index looked up by parseft with
+   local zone abbreviations probed at current time.  Abbreviations used
+   for different UTC offsets or DST flags since 1970 are not loaded.  This
+   must be called before threads are started.  Return true if loaded,
+   otherwise, false.  */
+
+TIMEUTILS_API bool loadtzabbrs (const char *dir);
+
+/* Initialize the specified context for the calculation of file time, in
+   which trans_isdst is 1, current time is gotten from FT_CLOCK_PRECISE,
+   and the sequence of pseudo-random values is generated for SEED, or
+   current time if SEED is less than 0.  */
+
+TIMEUTILS_API void initftcontext (FT_CONTEXT *ft_ctx, int seed);
+
+/* Get the current time on the clock selected in *FT_CTX as file time in
+   NTFS, which is captured by the first call and returned until the clock
+   is selected again if FT_CLOCK_FROZEN. Set its value into *FT and return
+   true if successfull, otherwise, return false.  */
+
+TIMEUTILS_API bool currentftctx (FT *ft, FT_CONTEXT *ft_ctx);
+
+/* Select the clock used by currentftctx in *FT_CTX.  */
+
+TIMEUTILS_API void selectftclock (FT_CONTEXT *ft_ctx, int ft_clock);
+
+/* Calculate file time for *NOW by members in *TM_CHG and set its value
+   into *FT. If the datetime_unset member is true, don't calculate and copy
+   *NOW changed by the modflag member to *FT. Return true if not overflow,
+   otherwise, false.  */
+
+TIMEUTILS_API bool calcft (FT *ft, const FT *now, const FT_CHANGE *ft_chg);
+
+/* Calculate file time for *NOW by members in *TM_CHG in the specified
+   context, as with calcft function. If FT_CTX is NULL, use the context of
+   a process. Return true if not overflow, otherwise, false.  */
+
+TIMEUTILS_API bool calcftctx (FT *ft, const FT *now, const FT_CHANGE *ft_chg,
+                              FT_CONTEXT *ft_ctx);
+
+/* Calculate file time for *NOW by members in *TM_CHG in the specified
+   context and the time zone of *TZ instead of local time zone, as with
+   calcftctx function. Return true if not overflow, otherwise, false.  */
+
+TIMEUTILS_API bool calcft_z (const TZ_HANDLE *tz, FT *ft, const FT *now,
+                             const FT_CHANGE *ft_chg, FT_CONTEXT *ft_ctx);
+
+/* Change the specified file time by members in *TM_CHG and set its value
+   to the file specified by *FT_FILE. If TM_CHG is NULL, copy directly it
+   to the file, or if a pointer included in FT_NOWP is NULL, set its time
+   to current time. Return true if successfull, otherwise, false.  */
+
+TIMEUTILS_API bool setft (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
+                          const FT_CHANGE *ft_chg);
+
+/* Change the specified file time by members in *TM_CHG in the specified
+   context and set its value to the file specified by *FT_FILE, as with
+   setft function. If FT_CTX is NULL, use the context of a process. Return
+   true if successfull, otherwise, false.  */
+
+TIMEUTILS_API bool setftctx (struct file *ft_file, const FT *ft_nowp[FT_SIZE],
+                             const FT_CHANGE *ft_chg, FT_CONTEXT *ft_ctx);
+
+/* Get file times for the specified struct file into FT and set the flag
+   of a directory into the isdir member in *FT_FILE. If the no_dereference
+   member is true, get the time of symbolic link but not a file referenced
+   by it. On GNU/Linux, set UTIME_OMIT into nanoseconds of the creation time
+   if not supported by the file. Return true if successfull, otherwise,
+   false.  */
+
+TIMEUTILS_API bool getft (FT ft[FT_SIZE], struct file *ft_file);
+
+/* Convert the specified parameters of time into seconds since 1970-01-01
+   00:00 UTC, and adjust each parameter to the range of correct values and
+   set those values back into *TM. Return the value of converted seconds
+   if conversion is performed, otherwise, return -1 and don't overwrite
+   members in *TM.  */
+
+TIMEUTILS_API intmax_t mktimew (TM *tm);
+
+/* Convert the specified seconds since 1970-01-01 00:00 UTC to local time
+   and set those parameters of time into *TM. Return the pointer to it
+   if conversion is performed, otherwise, NULL. */
+
+TIMEUTILS_API TM *localtimew (const intmax_t *seconds, TM *tm);
+
+/* Open the time zone of the specified name, which is the path of TZif
+   file relative to TZDIR or "/usr/share/zoneinfo", the absolute path, or
+   POSIX TZ string if its file is not found. Return the handle of it,
+   which is shared by threads, or NULL and set errno if not opened.  */
+
+TIMEUTILS_API TZ_HANDLE *tz_open (const char *name);
+
+/* Close the specified handle of a time zone.  */
+
+TIMEUTILS_API void tz_close (TZ_HANDLE *tz);
+
+/* Convert the specified seconds since 1970-01-01 00:00 UTC to local time
+   in the time zone of *TZ, as with localtimew function.  */
+
+TIMEUTILS_API TM *localtimew_z (const TZ_HANDLE *tz, const intmax_t *seconds,
+                                TM *tm);
+
+/* Convert the specified parameters of time in the time zone of *TZ into
+   seconds since 1970-01-01 00:00 UTC, as with mktimew function.  */
+
+TIMEUTILS_API intmax_t mktimew_z (const TZ_HANDLE *tz, TM *tm);
+#endif
@@ -0,0 +1,1128 @@
+/* Convert time in the time zone loaded from TZif file
+   Copyright (C) 2025 Yoshinori Kawagita.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#include "config.h"
+
+#ifdef USE_TM_GLIBC
+# include <time.h>
+#else
+# include <windows.h>
+#endif
+#include <dirent.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "adjusttm.h"
+#include "ftsec.h"
+#include "idx.h"
+#include "timeutils.h"
+#include "wintm.h"
+
+/* The directory of TZif files if the environment variable TZDIR is not
+   set  */
+#define TZ_DIR_DEFAULT "/usr/share/zoneinfo"
+
+/* The maximum length of the path of TZif file, plus 1  */
+#define TZ_PATH_MAX 4096
+
+/* The maximum depth of directories walked for TZif files  */
+#define TZ_DIR_DEPTH_MAX 8
+
+/* The maximum size of TZif file  */
+#define TZ_FILE_SIZE_MAX (1 << 20)
+
+/* The size of the header in TZif file  */
+#define TZ_HEADER_SIZE 44
+
+/* The last year whose transitions by the rule in the footer of TZif file
+   or POSIX TZ string are cached into the handle when it's opened  */
+#define TZ_RULE_CACHED_YEAR 2100
+
+/* The maximum number of transitions cached by the rule  */
+#define TZ_RULE_TRANS_MAX \
+  (2 * (TZ_RULE_CACHED_YEAR - UNIXEPOCH_YEAR + 2))
+
+/* The maximum absolute value of UTC offset  */
+#define TZ_UTCOFF_MAX (26 * 3600)
+
+/* The distance and maximum duration by which the time type whose DST
+   flag is different is probed in both directions, as same as mktime in
+   GNU C Library  */
+#define TZ_ISDST_STRIDE       601200
+#define TZ_ISDST_DURATION_MAX 457243200
+#define TZ_ISDST_DELTA_BOUND  (TZ_ISDST_DURATION_MAX / 2 + TZ_ISDST_STRIDE)
+
+/* The local time type of a time zone  */
+
+struct tz_type
+{
+  int32_t utoff;  /* Seconds east of UTC */
+  bool isdst;
+  int abbr;       /* Index of the abbreviation in abbrs */
+};
+
+/* The date and time of the transition by the rule in a year  */
+
+struct tz_ruledate
+{
+  char kind;     /* 'J' (Julian day), 'M' (month, week, and day), or 'D' */
+  int month;
+  int week;
+  int day;
+  int32_t time;  /* Seconds since the midnight of local time */
+};
+
+/* The handle of a time zone, which is never changed after opened  */
+
+struct tz_handle
+{
+  int64_t *trans;               /* Transition times, in ascending order */
+  unsigned short *trans_types;  /* Index of the type for each transition */
+  idx_t trans_num;
+  struct tz_type *types;
+  int type_num;
+  char *abbrs;                  /* Abbreviations terminated by '\0' */
+  int abbrs_size;
+  int first_type;   /* Type before the first transition */
+  int std_type;     /* Types of the rule, or -1 if not specified */
+  int dst_type;
+  struct tz_ruledate start;
+  struct tz_ruledate end;
+  int64_t rule_from;  /* Time from which the rule is evaluated directly */
+  int64_t cache_from; /* Range in which transitions by the rule are cached */
+  int64_t cache_to;
+};
+
+/* Return true if the specified character is an ASCII letter or digit.  */
+
+#define TZ_ISALPHA(c) \
+  (((c) >= 'A' && (c) <= 'Z') || ((c) >= 'a' && (c) <= 'z'))
+#define TZ_ISDIGIT(c) ((c) >= '0' && (c) <= '9')
+
+/* Return the 32 or 64-bit signed integer in big-endian at P.  */
+
+static int32_t
+tzget32 (const unsigned char *p)
+{
+  return (int32_t) ((uint32_t) p[0] << 24 | (uint32_t) p[1] << 16
+                    | (uint32_t) p[2] << 8 | (uint32_t) p[3]);
+}
+
+static int64_t
+tzget64 (const unsigned char *p)
+{
+  return (int64_t) ((uint64_t) (uint32_t) tzget32 (p) << 32
+                    | (uint64_t) (uint32_t) tzget32 (p + 4));
+}
+
+/* Allocate the handle of a time zone in a block, into which TRANS_NUM
+   transitions, TYPE_NUM types, and abbreviations of ABBRS_SIZE bytes are
+   stored, in addition to transitions and two types by the rule. Return
+   the pointer to it, or NULL if not allocated.  */
+
+static TZ_HANDLE *
+tzalloc (idx_t trans_num, int type_num, int abbrs_size)
+{
+  idx_t trans_max = trans_num + TZ_RULE_TRANS_MAX;
+  int type_max = type_num + 2;
+  TZ_HANDLE *tz = malloc (sizeof (TZ_HANDLE)
+                          + trans_max * sizeof (int64_t)
+                          + type_max * sizeof (struct tz_type)
+                          + trans_max * sizeof (unsigned short)
+                          + abbrs_size);
+
+  if (tz)
+    {
+      tz->trans = (int64_t *) (tz + 1);
+      tz->types = (struct tz_type *) (tz->trans + trans_max);
+      tz->trans_types = (unsigned short *) (tz->types + type_max);
+      tz->abbrs = (char *) (tz->trans_types + trans_max);
+      tz->trans_num = 0;
+      tz->type_num = 0;
+      tz->abbrs_size = 0;
+      tz->first_type = 0;
+      tz->std_type = tz->dst_type = -1;
+      tz->rule_from = tz->cache_from = tz->cache_to = INT64_MAX;
+    }
+
+  return tz;
+}
+
+/* Return the index of the type for the specified UTC offset, DST flag, and
+   abbreviation of LEN characters at NAME in *TZ, which is appended if not
+   found.  */
+
+static int
+tzaddtype (TZ_HANDLE *tz, int32_t utoff, bool isdst, const char *name,
+           int len)
+{
+  int abbr;
+  int i;
+
+  for (i = 0; i < tz->type_num; i++)
+    {
+      const char *s = tz->abbrs + tz->types[i].abbr;
+
+      if (tz->types[i].utoff == utoff && tz->types[i].isdst == isdst
+          && strncmp (s, name, len) == 0 && s[len] == '\0')
+        return i;
+    }
+
+  for (abbr = 0; abbr < tz->abbrs_size;
+       abbr += strlen (tz->abbrs + abbr) + 1)
+    {
+      if (strncmp (tz->abbrs + abbr, name, len) == 0
+          && tz->abbrs[abbr + len] == '\0')
+        break;
+    }
+
+  if (abbr >= tz->abbrs_size)
+    {
+      memcpy (tz->abbrs + abbr, name, len);
+      tz->abbrs[abbr + len] = '\0';
+      tz->abbrs_size += len + 1;
+    }
+
+  tz->types[i].utoff = utoff;
+  tz->types[i].isdst = isdst;
+  tz->types[i].abbr = abbr;
+  tz->type_num++;
+
+  return i;
+}
+
+/* Append the transition to the type of index TYPE at T into *TZ unless
+   T is not after the last transition or the type is not changed.  */
+
+static void
+tzaddtrans (TZ_HANDLE *tz, int64_t t, int type)
+{
+  idx_t n = tz->trans_num;
+
+  if (n > 0 && (t <= tz->trans[n - 1] || tz->trans_types[n - 1] == type))
+    return;
+
+  tz->trans[n] = t;
+  tz->trans_types[n] = type;
+  tz->trans_num++;
+}
+
+/* Parse the number not more than MAX at P and set its value into *NUM.
+   Return the pointer to the next character, or NULL if not parsed.  */
+
+static const char *
+tzparsenum (const char *p, int *num, int max)
+{
+  int n = 0;
+
+  if (! TZ_ISDIGIT (*p))
+    return NULL;
+
+  do
+    {
+      n = n * 10 + (*p++ - '0');
+      if (n > max)
+        return NULL;
+    }
+  while (TZ_ISDIGIT (*p));
+
+  *num = n;
+
+  return p;
+}
+
+/* Parse the time of "[+|-]hh[:mm[:ss]]" whose hours is not more than
+   HOUR_MAX at P and set its seconds into *SECONDS. Return the pointer to
+   the next character, or NULL if not parsed.  */
+
+static const char *
+tzparsetime (const char *p, int32_t *seconds, int hour_max)
+{
+  int sign = 1;
+  int hour;
+  int min = 0;
+  int sec = 0;
+
+  if (*p == '+' || *p == '-')
+    sign = *p++ == '-' ? -1 : 1;
+
+  p = tzparsenum (p, &hour, hour_max);
+  if (p && *p == ':')
+    {
+      p = tzparsenum (p + 1, &min, 59);
+      if (p && *p == ':')
+        p = tzparsenum (p + 1, &sec, 59);
+    }
+
+  if (p)
+    *seconds = sign * SECONDS_AT (hour, min, sec);
+
+  return p;
+}
+
+/* Parse the name of time zone, which is alphabetic characters or quoted
+   by '<' and '>', at P and set its start and length into *NAME and *LEN.
+   Return the pointer to the next character, or NULL if not parsed.  */
+
+static const char *
+tzparsename (const char *p, const char **name, int *len)
+{
+  const char *q;
+
+  if (*p == '<')
+    {
+      for (q = ++p; *q != '>'; q++)
+        {
+          if (! TZ_ISALPHA (*q) && ! TZ_ISDIGIT (*q)
+              && *q != '+' && *q != '-')
+            return NULL;
+        }
+
+      *name = p;
+      *len = q++ - p;
+    }
+  else
+    {
+      for (q = p; TZ_ISALPHA (*q); q++);
+
+      *name = p;
+      *len = q - p;
+    }
+
+  return *len >= 3 ? q : NULL;
+}
+
+/* Parse the date and time of "Jn", "n", or "Mm.w.d" followed by "/time"
+   optionally at P and set those values into *DATE. Return the pointer to
+   the next character, or NULL if not parsed.  */
+
+static const char *
+tzparsedate (const char *p, struct tz_ruledate *date)
+{
+  date->kind = *p;
+  date->time = 2 * 3600;
+
+  if (*p == 'J')
+    {
+      p = tzparsenum (p + 1, &date->day, 365);
+      if (p && date->day < 1)
+        return NULL;
+    }
+  else if (*p == 'M')
+    {
+      p = tzparsenum (p + 1, &date->month, 12);
+      if (! p || date->month < 1 || *p != '.'
+          || ! (p = tzparsenum (p + 1, &date->week, 5)) || date->week < 1
+          || *p != '.')
+        return NULL;
+      p = tzparsenum (p + 1, &date->day, 6);
+    }
+  else
+    {
+      date->kind = 'D';
+      p = tzparsenum (p, &date->day, 365);
+    }
+
+  if (p && *p == '/')
+    p = tzparsetime (p + 1, &date->time, 167);
+
+  return p;
+}
+
+/* Parse POSIX TZ string like "EST5EDT,M3.2.0,M11.1.0" at P and set types
+   and dates of its rule into *TZ. Return true if parsed, otherwise,
+   false.  */
+
+static bool
+tzparserule (TZ_HANDLE *tz, const char *p)
+{
+  const char *name;
+  int len;
+  int32_t offset;
+  int32_t dst_offset;
+
+  /* Offsets are hours west of UTC, which are inverted into UTC offsets
+     of types. */
+  p = tzparsename (p, &name, &len);
+  if (! p || ! (p = tzparsetime (p, &offset, 24)))
+    return false;
+
+  tz->std_type = tzaddtype (tz, -offset, false, name, len);
+
+  if (*p == '\0')
+    return true;
+  else if (! (p = tzparsename (p, &name, &len)))
+    return false;
+
+  dst_offset = offset - 3600;
+  if (*p != ',' && *p != '\0' && ! (p = tzparsetime (p, &dst_offset, 24)))
+    return false;
+
+  tz->dst_type = tzaddtype (tz, -dst_offset, true, name, len);
+
+  /* Use the rule in the United States if not specified, as same as
+     GNU C Library. */
+  if (*p == '\0')
+    {
+      tz->start = (struct tz_ruledate) { 'M', 3, 2, 0, 2 * 3600 };
+      tz->end = (struct tz_ruledate) { 'M', 11, 1, 0, 2 * 3600 };
+      return true;
+    }
+
+  return *p == ',' && (p = tzparsedate (p + 1, &tz->start)) && *p == ','
+         && (p = tzparsedate (p + 1, &tz->end)) && *p == '\0';
+}
+
+/* Return the day in the specified year for *DATE.  */
+
+static int
+tzruleyday (const struct tz_ruledate *date, int64_t year)
+{
+  int first, last, wday, yday;
+
+  switch (date->kind)
+    {
+    case 'J':
+      return date->day - 1 + (date->day >= 60 && ! HAS_NOLEAPDAY (year));
+    case 'M':
+      first = YEAR_DAYS (year, date->month - 1);
+      last = YEAR_DAYS (year, date->month) - 1;
+      wday = WEEKDAY_FROM (UNIXEPOCH_WEEKDAY, EPOCH_DAYS (year, first));
+      yday = first + (date->day - wday + 7) % 7 + (date->week - 1) * 7;
+      while (yday > last)
+        yday -= 7;
+      return yday;
+    default:
+      return date->day;
+    }
+}
+
+/* Set times of the transition to DST and standard time by the rule in
+   the specified year into TIMES[0] and TIMES[1].  */
+
+static void
+tzruletrans (const TZ_HANDLE *tz, int64_t year, int64_t times[2])
+{
+  times[0] = EPOCH_DAYS (year, tzruleyday (&tz->start, year)) * SECONDS_IN_DAY
+             + tz->start.time - tz->types[tz->std_type].utoff;
+  times[1] = EPOCH_DAYS (year, tzruleyday (&tz->end, year)) * SECONDS_IN_DAY
+             + tz->end.time - tz->types[tz->dst_type].utoff;
+}
+
+/* Return the year in local time for the specified seconds since
+   1970-01-01 00:00.  */
+
+static int64_t
+tzyear (int64_t seconds)
+{
+  struct dtm64 date = (struct dtm64) { .tm_mday = 1, .tm_mon = 0,
+                                       .tm_year = UNIXEPOCH_YEAR
+                                                  - TM_YEAR_BASE };
+  int64_t days = adjustday64 (&date);
+
+  adjustdaysec (&date, &days, seconds);
+
+  return date.tm_year + TM_YEAR_BASE;
+}
+
+/* Return the type for T by the rule in *TZ and set the time of the next
+   transition after T into *NEXT.  */
+
+static const struct tz_type *
+tzrule (const TZ_HANDLE *tz, int64_t t, int64_t *next)
+{
+  int64_t year = tzyear (t + tz->types[tz->std_type].utoff);
+  int64_t times[6];
+  bool isdsts[6];
+  bool isdst;
+  int i, j;
+
+  /* Sort transitions in the preceding, current, and following year,
+     which are enough to find those before and after T. */
+  for (i = 0; i < 3; i++)
+    {
+      int64_t pair[2];
+
+      tzruletrans (tz, year - 1 + i, pair);
+
+      for (j = 0; j < 2; j++)
+        {
+          int k = i * 2 + j;
+
+          while (k > 0 && times[k - 1] > pair[j])
+            {
+              times[k] = times[k - 1];
+              isdsts[k] = isdsts[k - 1];
+              k--;
+            }
+          times[k] = pair[j];
+          isdsts[k] = j == 0;
+        }
+    }
+
+  isdst = ! isdsts[0];
+  *next = INT64_MAX;
+
+  for (i = 0; i < 6; i++)
+    {
+      if (times[i] > t)
+        {
+          *next = times[i];
+          break;
+        }
+      isdst = isdsts[i];
+    }
+
+  return tz->types + (isdst ? tz->dst_type : tz->std_type);
+}
+
+/* Cache transitions by the rule from FROM_YEAR to TZ_RULE_CACHED_YEAR into
+   *TZ, after which the rule is evaluated directly. Years before 1970 are
+   not cached because the handle has room only for transitions since it,
+   so the rule is also evaluated directly for them after the transition
+   last read from the file.  */
+
+static void
+tzcache (TZ_HANDLE *tz, int64_t from_year)
+{
+  idx_t n = tz->trans_num;
+  int64_t year;
+  int64_t cache_to;
+
+  if (from_year < UNIXEPOCH_YEAR)
+    from_year = UNIXEPOCH_YEAR;
+
+  for (year = from_year; year <= TZ_RULE_CACHED_YEAR; year++)
+    {
+      int64_t times[2];
+      int i;
+
+      /* Transitions are reversed in the southern hemisphere. */
+      tzruletrans (tz, year, times);
+      i = times[0] > times[1];
+      tzaddtrans (tz, times[i], i ? tz->std_type : tz->dst_type);
+      tzaddtrans (tz, times[! i], i ? tz->dst_type : tz->std_type);
+    }
+
+  cache_to = EPOCH_DAYS (TZ_RULE_CACHED_YEAR + 1, 0) * SECONDS_IN_DAY
+             - tz->types[tz->std_type].utoff;
+  if (tz->trans_num > 0 && cache_to <= tz->trans[tz->trans_num - 1])
+    cache_to = tz->trans[tz->trans_num - 1] + 1;
+
+  tz->cache_from = tz->trans_num > n ? tz->trans[n] : cache_to;
+  tz->cache_to = cache_to;
+  tz->rule_from = n > 0 ? tz->trans[n - 1] + 1 : tz->cache_from;
+}
+
+/* Return the type for T in *TZ and set the time of the next transition
+   after T into *NEXT, or INT64_MAX if not found.  */
+
+static const struct tz_type *
+tzlookup (const TZ_HANDLE *tz, int64_t t, int64_t *next)
+{
+  idx_t n = tz->trans_num;
+  idx_t lo, hi;
+
+  if ((t >= tz->rule_from && t < tz->cache_from) || t >= tz->cache_to)
+    return tzrule (tz, t, next);
+  else if (n == 0 || t < tz->trans[0])
+    {
+      *next = n > 0 ? tz->trans[0] : tz->cache_to;
+      return tz->types + tz->first_type;
+    }
+
+  /* Search the last transition not after T. */
+  lo = 0;
+  hi = n;
+  while (hi - lo > 1)
+    {
+      idx_t mid = lo + (hi - lo) / 2;
+
+      if (tz->trans[mid] <= t)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  *next = lo + 1 < n ? tz->trans[lo + 1] : tz->cache_to;
+
+  return tz->types + tz->trans_types[lo];
+}
+
+/* Load the time zone from BUF of SIZE bytes in TZif format. Return the
+   handle of it, or NULL if not loaded.  */
+
+static TZ_HANDLE *
+tzload (unsigned char *buf, size_t size)
+{
+  const unsigned char *p = buf;
+  const unsigned char *end = buf + size;
+  const unsigned char *idxs, *types;
+  char *footer = NULL;
+  int timesize = 4;
+  uint32_t isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt;
+  size_t datasize;
+  TZ_HANDLE *tz;
+  idx_t i;
+
+  /* Skip the data in version 1 if 64-bit data is included in version 2
+     or later. */
+  while (true)
+    {
+      if (end - p < TZ_HEADER_SIZE || memcmp (p, "TZif", 4) != 0)
+        return NULL;
+
+      isutcnt = tzget32 (p + 20);
+      isstdcnt = tzget32 (p + 24);
+      leapcnt = tzget32 (p + 28);
+      timecnt = tzget32 (p + 32);
+      typecnt = tzget32 (p + 36);
+      charcnt = tzget32 (p + 40);
+
+      if (timecnt > TZ_FILE_SIZE_MAX || typecnt < 1 || typecnt > 256
+          || charcnt < 1 || charcnt > 256 * 7
+          || (isutcnt != 0 && isutcnt != typecnt)
+          || (isstdcnt != 0 && isstdcnt != typecnt)
+          || leapcnt > TZ_FILE_SIZE_MAX)
+        return NULL;
+
+      datasize = timecnt * (timesize + 1) + typecnt * 6 + charcnt
+                 + leapcnt * (timesize + 4) + isstdcnt + isutcnt;
+      if ((size_t) (end - p) - TZ_HEADER_SIZE < datasize)
+        return NULL;
+      else if (timesize == 8 || p[4] < '2')
+        break;
+
+      p += TZ_HEADER_SIZE + datasize;
+      timesize = 8;
+    }
+
+  /* Leap seconds are not supported because those are not counted by
+     seconds since 1970-01-01 00:00 UTC. */
+  if (leapcnt > 0)
+    return NULL;
+
+  p += TZ_HEADER_SIZE;
+  idxs = p + timecnt * timesize;
+  types = idxs + timecnt;
+
+  /* Terminate the footer of POSIX TZ string by the null character. */
+  if (timesize == 8)
+    {
+      unsigned char *q = (unsigned char *) p + datasize;
+
+      if (q >= end || *q != '\n'
+          || ! (footer = memchr (q + 1, '\n', end - q - 1)))
+        return NULL;
+
+      *footer = '\0';
+      footer = (char *) q + 1;
+    }
+
+  tz = tzalloc (timecnt, typecnt,
+                charcnt + (footer ? strlen (footer) + 2 : 0));
+  if (! tz)
+    return NULL;
+
+  memcpy (tz->abbrs, types + typecnt * 6, charcnt);
+  tz->abbrs_size = charcnt;
+  if (tz->abbrs[charcnt - 1] != '\0')
+    goto invalid;
+
+  for (i = 0; i < typecnt; i++)
+    {
+      const unsigned char *q = types + i * 6;
+      int32_t utoff = tzget32 (q);
+
+      if (utoff <= -TZ_UTCOFF_MAX || utoff >= TZ_UTCOFF_MAX
+          || q[4] > 1 || q[5] >= charcnt)
+        goto invalid;
+
+      tz->types[i].utoff = utoff;
+      tz->types[i].isdst = q[4];
+      tz->types[i].abbr = q[5];
+    }
+  tz->type_num = typecnt;
+
+  for (i = 0; i < timecnt; i++)
+    {
+      int64_t t = timesize == 8 ? tzget64 (p + i * 8) : tzget32 (p + i * 4);
+
+      if (idxs[i] >= typecnt || (i > 0 && t <= tz->trans[i - 1]))
+        goto invalid;
+
+      tz->trans[i] = t;
+      tz->trans_types[i] = idxs[i];
+    }
+  tz->trans_num = timecnt;
+
+  /* Cache transitions by the rule in the footer after the last one. */
+  if (footer && *footer != '\0')
+    {
+      if (! tzparserule (tz, footer))
+        goto invalid;
+      else if (tz->dst_type >= 0)
+        tzcache (tz, timecnt > 0
+                     ? tzyear (tz->trans[timecnt - 1]
+                               + tz->types[tz->std_type].utoff)
+                     : UNIXEPOCH_YEAR);
+    }
+
+  return tz;
+
+invalid:
+  free (tz);
+  return NULL;
+}
+
+/* Return the directory of TZif files, which is TZDIR or the default.  */
+
+static const char *
+tzdir (void)
+{
+  const char *dir = getenv ("TZDIR");
+
+  return dir && *dir != '\0' ? dir : TZ_DIR_DEFAULT;
+}
+
+/* Open the TZif file of NAME in the directory set by TZDIR, or the
+   absolute path. Return the stream of it, or NULL if not opened.  */
+
+static FILE *
+tzfopen (const char *name)
+{
+  const char *dir = tzdir ();
+  char *path;
+  FILE *fp;
+
+  if (*name == '/' || *name == '\\'
+      || (TZ_ISALPHA (*name) && name[1] == ':'))
+    return fopen (name, "rb");
+  else if (strstr (name, ".."))
+    {
+      errno = EINVAL;
+      return NULL;
+    }
+
+  path = malloc (strlen (dir) + strlen (name) + 2);
+  if (! path)
+    return NULL;
+
+  sprintf (path, "%s/%s", dir, name);
+  fp = fopen (path, "rb");
+  free (path);
+
+  return fp;
+}
+
+/* Read TZif file from FP into BUF of TZ_FILE_SIZE_MAX + 1 bytes and close
+   it. Return the handle of the time zone loaded from it, or NULL and set
+   errno if not loaded.  */
+
+static TZ_HANDLE *
+tzread (FILE *fp, unsigned char *buf)
+{
+  TZ_HANDLE *tz;
+  size_t size = fread (buf, 1, TZ_FILE_SIZE_MAX + 1, fp);
+  int err = ferror (fp) ? errno : 0;
+
+  fclose (fp);
+
+  tz = ! err && size <= TZ_FILE_SIZE_MAX ? tzload (buf, size) : NULL;
+  if (! tz)
+    errno = err ? err : EINVAL;
+
+  return tz;
+}
+
+/* Open the time zone of the specified name, which is the path of TZif
+   file relative to TZDIR or "/usr/share/zoneinfo", the absolute path, or
+   POSIX TZ string if its file is not found. Return the handle of it,
+   which is shared by threads, or NULL and set errno if not opened.  */
+
+TZ_HANDLE *
+tz_open (const char *name)
+{
+  FILE *fp;
+  TZ_HANDLE *tz;
+
+  if (*name == ':')
+    name++;
+
+  if (*name == '\0')
+    {
+      errno = EINVAL;
+      return NULL;
+    }
+  else if ((fp = tzfopen (name)) != NULL)
+    {
+      unsigned char *buf = malloc (TZ_FILE_SIZE_MAX + 1);
+
+      if (! buf)
+        {
+          fclose (fp);
+          return NULL;
+        }
+
+      tz = tzread (fp, buf);
+      free (buf);
+
+      return tz;
+    }
+  else if (errno != ENOENT)
+    return NULL;
+
+  tz = tzalloc (0, 0, strlen (name) + 2);
+  if (! tz)
+    return NULL;
+  else if (! tzparserule (tz, name))
+    {
+      free (tz);
+      errno = EINVAL;
+      return NULL;
+    }
+
+  /* Use the type at 1970-01-01 00:00 UTC before it, as same as GNU C
+     Library. */
+  if (tz->dst_type >= 0)
+    {
+      int64_t next;
+
+      tz->first_type = tzrule (tz, 0, &next) - tz->types;
+      tzcache (tz, UNIXEPOCH_YEAR);
+    }
+  else
+    tz->first_type = tz->std_type;
+
+  return tz;
+}
+
+/* Close the specified handle of a time zone.  */
+
+void
+tz_close (TZ_HANDLE *tz)
+{
+  free (tz);
+}
+
+/* Return true if no transition occurs after FROM until TO in the time zone
+   of *TZ, and set the UTC offset and DST flag of the type at FROM into
+   *UTOFF and *ISDST.  */
+
+bool
+tz_fixedtype (const TZ_HANDLE *tz, intmax_t from, intmax_t to,
+              long int *utoff, int *isdst)
+{
+  int64_t next;
+  const struct tz_type *type = tzlookup (tz, from, &next);
+
+  *utoff = type->utoff;
+  *isdst = type->isdst;
+
+  return next > to;
+}
+
+/* Return true if the type at INDEX is used since 1970-01-01 00:00 UTC in
+   the time zone of *TZ.  */
+
+static bool
+tztypeused (const TZ_HANDLE *tz, int index)
+{
+  int64_t next;
+  idx_t i;
+
+  if (index == tz->std_type || index == tz->dst_type
+      || tzlookup (tz, 0, &next) == tz->types + index)
+    return true;
+
+  for (i = tz->trans_num - 1; i >= 0 && tz->trans[i] > 0; i--)
+    if (tz->trans_types[i] == index)
+      return true;
+
+  return false;
+}
+
+/* Walk the directory or file of PATH whose length is LEN in the buffer of
+   TZ_PATH_MAX bytes, reading TZif files into BUF, as with tz_walktypes.  */
+
+static bool
+tzwalk (char *path, size_t len, int depth, unsigned char *buf,
+        bool (*func) (const char *, long int, bool, void *), void *arg)
+{
+  struct stat st;
+
+  if (stat (path, &st) != 0)
+    return true;
+  else if (S_ISDIR (st.st_mode))
+    {
+      DIR *dirp;
+      struct dirent *ent;
+      bool walked = true;
+
+      if (depth >= TZ_DIR_DEPTH_MAX || (dirp = opendir (path)) == NULL)
+        return true;
+
+      while (walked && (ent = readdir (dirp)) != NULL)
+        {
+          size_t namelen = strlen (ent->d_name);
+
+          /* Skip hidden files and directories of the same time zones
+             as others in "posix" or with leap seconds in "right".  */
+          if (ent->d_name[0] == '.' || strcmp (ent->d_name, "posix") == 0
+              || strcmp (ent->d_name, "right") == 0
+              || len + namelen + 2 > TZ_PATH_MAX)
+            continue;
+
+          path[len] = '/';
+          memcpy (path + len + 1, ent->d_name, namelen + 1);
+          walked = tzwalk (path, len + namelen + 1, depth + 1, buf,
+                           func, arg);
+        }
+
+      closedir (dirp);
+      path[len] = '\0';
+
+      return walked;
+    }
+  else
+    {
+      FILE *fp = fopen (path, "rb");
+      TZ_HANDLE *tz;
+      int i;
+
+      /* Ignore files which are not in TZif format.  */
+      if (! fp || (tz = tzread (fp, buf)) == NULL)
+        return true;
+
+      for (i = 0; i < tz->type_num; i++)
+        {
+          const struct tz_type *type = tz->types + i;
+
+          if (tztypeused (tz, i)
+              && ! func (tz->abbrs + type->abbr, type->utoff, type->isdst,
+                         arg))
+            {
+              tz_close (tz);
+              return false;
+            }
+        }
+
+      tz_close (tz);
+
+      return true;
+    }
+}
+
+/* Call FUNC with the abbreviation, UTC offset, and DST flag of each local
+   time type used since 1970-01-01 00:00 UTC in all TZif files under DIR,
+   or TZDIR or "/usr/share/zoneinfo" if NULL, and ARG until it returns
+   false. Return true if all files are walked, otherwise, false.  */
+
+bool
+tz_walktypes (const char *dir,
+              bool (*func) (const char *abbr, long int utoff, bool isdst,
+                            void *arg), void *arg)
+{
+  size_t len;
+  char *path;
+  unsigned char *buf;
+  struct stat st;
+  bool walked = false;
+
+  if (! dir)
+    dir = tzdir ();
+
+  len = strlen (dir);
+  if (len >= TZ_PATH_MAX)
+    {
+      errno = ENAMETOOLONG;
+      return false;
+    }
+  else if (stat (dir, &st) != 0)
+    return false;
+  else if (! S_ISDIR (st.st_mode))
+    {
+      errno = ENOTDIR;
+      return false;
+    }
+
+  path = malloc (TZ_PATH_MAX);
+  buf = malloc (TZ_FILE_SIZE_MAX + 1);
+  if (path && buf)
+    {
+      memcpy (path, dir, len + 1);
+      walked = tzwalk (path, len, 0, buf, func, arg);
+    }
+
+  free (buf);
+  free (path);
+
+  return walked;
+}
+
+/* Set parameters of time for the specified seconds in the type of *TZ
+   into *TM.  */
+
+static void
+tzsettm (const TZ_HANDLE *tz, const struct tz_type *type, int64_t seconds,
+         TM *tm)
+{
+  struct dtm64 date = (struct dtm64) { .tm_mday = 1, .tm_mon = 0,
+                                       .tm_year = UNIXEPOCH_YEAR
+                                                  - TM_YEAR_BASE };
+  int64_t days = adjustday64 (&date);
+  int daysec = adjustdaysec (&date, &days, seconds + type->utoff);
+
+  tm->tm_year = date.tm_year;
+  tm->tm_mon = date.tm_mon;
+  tm->tm_mday = date.tm_mday;
+  tm->tm_hour = daysec / 3600;
+  tm->tm_min = daysec / 60 % 60;
+  tm->tm_sec = daysec % 60;
+  tm->tm_wday = date.tm_wday;
+  tm->tm_yday = date.tm_yday;
+  tm->tm_isdst = type->isdst;
+  tm->tm_gmtoff = type->utoff;
+#ifdef USE_TM_GLIBC
+  tm->tm_zone = tz->abbrs + type->abbr;
+#endif
+}
+
+/* Convert the specified seconds since 1970-01-01 00:00 UTC to local time
+   in the time zone of *TZ and set those parameters of time into *TM.
+   Return the pointer to it if conversion is performed, otherwise,
+   NULL.  */
+
+TM *
+localtimew_z (const TZ_HANDLE *tz, const intmax_t *seconds, TM *tm)
+{
+  int64_t next;
+
+  if (secoverflow (*seconds, 0))
+    return NULL;
+
+  tzsettm (tz, tzlookup (tz, *seconds, &next), *seconds, tm);
+
+  return tm;
+}
+
+/* Convert the specified parameters of time in the time zone of *TZ into
+   seconds since 1970-01-01 00:00 UTC, as with mktimew function. For a
+   time skipped over by a transition, use the UTC offset before it unless
+   the tm_isdst member matches only the type after it, or for a repeated
+   time, use the earlier unless it matches only the later.  */
+
+intmax_t
+mktimew_z (const TZ_HANDLE *tz, TM *tm)
+{
+  struct dtm64 date = (struct dtm64) { .tm_mday = tm->tm_mday,
+                                       .tm_mon = tm->tm_mon,
+                                       .tm_year = tm->tm_year };
+  int64_t days = adjustday64 (&date);
+  int64_t local = days * SECONDS_IN_DAY
+                  + SECONDS_AT ((int64_t) tm->tm_hour,
+                                (int64_t) tm->tm_min, tm->tm_sec);
+  int64_t start = local - TZ_UTCOFF_MAX;
+  int64_t t = 0;
+  int64_t next;
+  bool isdst = tm->tm_isdst > 0;
+  const struct tz_type *found_type = NULL;
+  const struct tz_type *prev_type = NULL;
+  const struct tz_type *gap_types[2] = { NULL, NULL };
+
+  /* Find the time for LOCAL in each interval between transitions within
+     the maximum UTC offset, or the gap skipped over by a transition. */
+  while (start <= local + TZ_UTCOFF_MAX)
+    {
+      const struct tz_type *type = tzlookup (tz, start, &next);
+      int64_t cand = local - type->utoff;
+
+      if (cand >= start && cand < next)
+        {
+          if (! found_type
+              || (tm->tm_isdst >= 0 && found_type->isdst != isdst
+                  && type->isdst == isdst))
+            {
+              found_type = type;
+              t = cand;
+            }
+        }
+      else if (cand < start && prev_type && ! gap_types[0]
+               && local - prev_type->utoff >= start)
+        {
+          gap_types[0] = prev_type;
+          gap_types[1] = type;
+        }
+
+      prev_type = type;
+      start = next;
+    }
+
+  if (found_type)
+    {
+      /* Use the UTC offset of the nearest type whose DST flag is matched,
+         or assume that DST is one hour ahead if not found. */
+      if (tm->tm_isdst >= 0 && found_type->isdst != isdst)
+        {
+          int64_t delta;
+          int dir;
+
+          for (delta = TZ_ISDST_STRIDE; delta < TZ_ISDST_DELTA_BOUND;
+               delta += TZ_ISDST_STRIDE)
+            {
+              for (dir = -1; dir <= 1; dir += 2)
+                {
+                  const struct tz_type *type =
+                    tzlookup (tz, t + delta * dir, &next);
+
+                  if (type->isdst == isdst)
+                    {
+                      t = local - type->utoff;
+                      goto offset_found;
+                    }
+                }
+            }
+
+          t += isdst ? -3600 : 3600;
+        }
+    }
+  else if (gap_types[0])
+    {
+      const struct tz_type *type = gap_types[0];
+
+      if (tm->tm_isdst >= 0 && type->isdst != isdst
+          && gap_types[1]->isdst == isdst)
+        type = gap_types[1];
+
+      t = local - type->utoff;
+    }
+  else
+    return -1;
+
+offset_found:
+  if (secoverflow (t, 0))
+    return -1;
+
+  tzsettm (tz, tzlookup (tz, t, &next), t, tm);
+
+  return t;
+}
@@ -19,30 +19,13 @@
 
 #include "adjusttm.h"
 
-/* The week day at January 1st in Year 0  */
-#define YEAR0_1ST_WEEKDAY 6
+/* Define the function for the ABI instead of the macro  */
+#undef weekday
 
 /* Return the week day for the specified day in YEAR.  */
 
 int
 weekday (int year, int yday)
 {
-  int days = yday % 7 + (yday < 0 ? 7 : 0);
-  int y = year % 400;
-  if (y)
-    {
-      if (y < 0)
-        y += 400;
-      adjusttm (&days, DAYS_IN_100YEARS, &y, 100);
-      adjusttm (&days, DAYS_IN_4YEARS, &y, 4);
-      days += DAYS_IN_YEAR * y;
-
-      /* Don't increment the number of days for a leap day in YEAR
-         but increment for the leap year divided by 400 because it's
-         counted for years from 0 to y - 1. */
-      if (HAS_NOLEAPDAY (y))
-        days++;
-    }
-
-  return (days + YEAR0_1ST_WEEKDAY) % 7;
+  return weekday_inline (year, yday);
 }
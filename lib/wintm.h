@@ -16,6 +16,9 @@
    along with this program; if not, write to the Free Software Foundation,
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.  */
 
+#ifndef WINTM_H_
+# define WINTM_H_
+
 /* The year which is set as a zero into the struct TM  */
 
 #ifndef TM_YEAR_BASE
@@ -55,8 +58,63 @@ struct wintm
 
 intmax_t mktimew (TM *tm);
 
+/* Convert the specified parameters of time into seconds since 1970-01-01
+   00:00 UTC, as with mktimew function. If DST is in effect or not for a
+   time that is either skipped over or repeated when a transition to or
+   from DST occurs, specify a positive value or zero into TRANS_ISDST,
+   otherwise, attempt to determine whether the time is included in the
+   term of DST, which is available only for the own implementation.  */
+
+intmax_t mktimewtrans (TM *tm, int trans_isdst);
+
 /* Convert the specified seconds since 1970-01-01 00:00 UTC to local time
    and set those parameters of time into *TM. Return the pointer to it
    if conversion is performed, otherwise, NULL. */
 
 TM *localtimew (const intmax_t *seconds, TM *tm);
+
+/* The handle of a time zone loaded from TZif file or POSIX TZ string,
+   whose transitions are cached and never changed after opened  */
+
+typedef struct tz_handle TZ_HANDLE;
+
+/* Open the time zone of the specified name, which is the path of TZif
+   file relative to TZDIR or "/usr/share/zoneinfo", the absolute path, or
+   POSIX TZ string if its file is not found. Return the handle of it,
+   which is shared by threads, or NULL and set errno if not opened.  */
+
+TZ_HANDLE *tz_open (const char *name);
+
+/* Close the specified handle of a time zone.  */
+
+void tz_close (TZ_HANDLE *tz);
+
+/* Convert the specified seconds since 1970-01-01 00:00 UTC to local time
+   in the time zone of *TZ, as with localtimew function.  */
+
+TM *localtimew_z (const TZ_HANDLE *tz, const intmax_t *seconds, TM *tm);
+
+/* Convert the specified parameters of time in the time zone of *TZ into
+   seconds since 1970-01-01 00:00 UTC, as with mktimew function. For a
+   time skipped over by a transition, use the UTC offset before it unless
+   the tm_isdst member matches only the type after it, or for a repeated
+   time, use the earlier unless it matches only the later.  */
+
+intmax_t mktimew_z (const TZ_HANDLE *tz, TM *tm);
+
+/* Return true if no transition occurs after FROM until TO in the time zone
+   of *TZ, and set the UTC offset and DST flag of the type at FROM into
+   *UTOFF and *ISDST.  */
+
+bool tz_fixedtype (const TZ_HANDLE *tz, intmax_t from, intmax_t to,
+                   long int *utoff, int *isdst);
+
+/* Call FUNC with the abbreviation, UTC offset, and DST flag of each local
+   time type used since 1970-01-01 00:00 UTC in all TZif files under DIR,
+   or TZDIR or "/usr/share/zoneinfo" if NULL, and ARG until it returns
+   false. Return true if all files are walked, otherwise, false.  */
+
+bool tz_walktypes (const char *dir,
+                   bool (*func) (const char *abbr, long int utoff,
+                                 bool isdst, void *arg), void *arg);
+#endif
@@ -19,12 +19,8 @@
 
 #include "adjusttm.h"
 
-/* Days for months since January in a year  */
-
-static const int ydays[] =
-{
-  0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, DAYS_IN_YEAR
-};
+/* Define the function for the ABI instead of the macro  */
+#undef yeardays
 
 /* Return the number of days for the specified months since January in
    a year if its value is from 0 to 12, otherwise, -1.  */
@@ -32,13 +28,5 @@ static const int ydays[] =
 int
 yeardays (bool has_noleapday, int months)
 {
-  if (months >= 0 && months <= 12)
-    {
-      if (has_noleapday || months < 2)
-        return ydays[months];
-
-      return ydays[months] + 1;
-    }
-
-  return -1;
+  return yeardays_inline (has_noleapday, months);
 }
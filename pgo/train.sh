@@ -0,0 +1,82 @@
+#!/bin/sh
+# train.sh -- Run representative workloads for profile-guided optimization
+#
+# Copyright (C) 2025 Yoshinori Kawagita.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# Usage: train.sh DIR
+#
+# Run touch and test commands built into DIR by instrumented objects,
+# which stamp files by -d, -t, and the manifest in bulk, parse strings
+# of date and time, and convert times, in a temporary directory. Exit
+# with the failure status if any command fails, because the profile is
+# not written for code on which the workload is not run.
+
+set -e
+
+bindir=${1:-glibc}
+case $bindir in
+/*) ;;
+*) bindir=`pwd`/$bindir ;;
+esac
+
+workdir=`mktemp -d "${TMPDIR:-/tmp}/timeutils-pgo.XXXXXX"` || exit 1
+trap 'rm -rf "$workdir"' 0 1 2 15
+
+cd "$workdir" || exit 1
+
+# Generate the list of dates and times by awk, which is common.
+awk 'BEGIN {
+  for (i = 0; i < 20000; i++)
+    {
+      y = 1950 + i % 120; m = 1 + i % 12; d = 1 + i % 28;
+      printf "%04d-%02d-%02dT%02d:%02d:%02d.%09dZ\n",
+             y, m, d, i % 24, i % 60, (i * 7) % 60, i * 4999;
+    }
+}' > iso8601.txt
+
+awk 'BEGIN {
+  for (i = 0; i < 2000; i++)
+    printf "f%d\t%04d-%02d-%02dT%02d:%02d:%02d+0900\n",
+           i, 1970 + i % 60, 1 + i % 12, 1 + i % 28, i % 24, i % 60, i % 60;
+}' > manifest.txt
+
+# Stamp files in bulk by the manifest, -d, and -t.
+mkdir files && cd files || exit 1
+"$bindir/touch" --manifest=../manifest.txt
+for d in "2024-05-06 07:08:09" "last friday" "@1700000000.123456789" \
+         "next month 3 hours ago" "2001-02-03T04:05:06+0900" \
+         "1 year 2 months 3 days" "tomorrow 12:00" "yesterday 23:59:59"; do
+  "$bindir/touch" -d "$d" f0 f1 f2 f3 f4 f5 f6 f7 f8 f9
+done
+for t in 202405060708.09 9912312359 01010000 197001010000.00; do
+  "$bindir/touch" -t "$t" f10 f11 f12 f13 f14 f15 f16 f17 f18 f19
+done
+"$bindir/touch" --round-up --ns-random=1 -e f20 f21 f22 f23 f24
+cd .. || exit 1
+
+# Convert ISO 8601 into seconds in bulk.
+"$bindir/iso8601sec" -q iso8601.txt
+
+# Parse strings of date and time, and calculate and convert times.
+for s in "2024-05-06 07:08:09 +0900" "next friday" "3 weeks ago" \
+         "Jan 5 2020 5pm EST" "@-1.5" "2 days 4 hours 30 minutes ago" \
+         "last day" "2024-05-06T07:08:09" "12:00 tomorrow UTC"; do
+  "$bindir/parseft" "$s" > /dev/null
+done
+
+i=0
+while [ $i -lt 200 ]; do
+  "$bindir/setft" - 20`expr $i % 100 + 10`-0`expr $i % 9 + 1`-15T12:34:56 \
+    0 `expr $i % 13` `expr $i % 40` $i 0 0 0 > /dev/null
+  "$bindir/mktime" -- `expr 1900 + $i` `expr $i % 14` `expr $i % 35` \
+    `expr $i % 25` 30 0 > /dev/null
+  "$bindir/localtime" -- `expr $i \* 15768000 - 1000000000` > /dev/null
+  "$bindir/adjustday" -- `expr 1900 + $i` `expr $i % 30 - 10` \
+    `expr $i \* 7 - 400` > /dev/null
+  i=`expr $i + 1`
+done
@@ -21,7 +21,6 @@
 #include "config.h"
 
 #ifdef USE_TM_GLIBC
-# include <string.h>
 # include <time.h>
 # include <unistd.h>
 # include "fd-reopen.h"
@@ -29,10 +28,13 @@
 #else
 # include <windows.h>
 #endif
+#include <errno.h>
 #include <getopt.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "argempty.h"
 #include "argmatch.h"
@@ -43,6 +45,7 @@
 #include "error.h"
 #include "exit.h"
 #include "posixtm.h"
+#include "splitlines.h"
 #include "wintm.h"
 
 #define _(msgid) (msgid)
@@ -81,23 +84,29 @@ static bool use_ref;
 /* (-e) If true, use times from each file.  */
 static bool use_each;
 
+/* The mask of times which must be gotten from a file.  */
+static int used_mask = FT_ATIME_MASK | FT_MTIME_MASK;
+
 /* New access, modification, and creation times to use when setting time.  */
 static FT newtime[FT_SIZE];
 
 /* File to use for -r. */
 static struct file ref_file;
 
-/* If DST is in effect or not for a time that is either skipped over or
-   repeated when a transition to or from DST occurs, specify a positive
-   value or zero, otherwise, attempt to determine whether the specified
-   time is included in the term of DST.  */
-int trans_isdst = 1;
+/* (--manifest) File listing each file and its times, or NULL.  */
+static char const *manifest;
+
+/* The context in which file time is calculated, whose trans_isdst is
+   changed by -T and the sequence of pseudo-random values is generated
+   by --ns-random.  */
+static FT_CONTEXT ft_context = { .trans_isdst = 1 };
 
 /* For long options that have no equivalent short option, use a
    non-character as a pseudo short option, starting with CHAR_MAX + 1.  */
 enum
 {
   TIME_OPTION = 256,
+  MANIFEST_OPTION,
   NS_PERMUTE_OPTION,
   NS_RANDOM_OPTION,
   ROUND_DOWN_OPTION,
@@ -116,11 +125,13 @@ static struct option const longopts[] =
   {"reference-each", no_argument, NULL, 'e'},
 #ifdef USE_TM_GLIBC
   {"no-dereference", no_argument, NULL, 'h'},
-#else
-  {"use-btime", no_argument, NULL, 'C'},
+#endif
+#if FT_SIZE > FT_BTIME
+  {"use-btime", no_argument, NULL, 'B'},
 #endif
   {"use-atime", no_argument, NULL, 'A'},
   {"use-mtime", no_argument, NULL, 'M'},
+  {"manifest", required_argument, NULL, MANIFEST_OPTION},
   {"ns-permute", no_argument, NULL, NS_PERMUTE_OPTION},
   {"ns-random", required_argument, NULL, NS_RANDOM_OPTION},
   {"round-down", no_argument, NULL, ROUND_DOWN_OPTION},
@@ -160,7 +171,7 @@ touch (struct file *ft_file, const FT_CHANGE *ft_chg, bool date_set)
   int open_errno = 0;
   int set_errno = 0;
 
-  if (IS_FILE_STDOUT (ft_file) || getft (ft, ft_file)
+  if (IS_FILE_STDOUT (ft_file) || getftmask (ft, ft_file, used_mask)
       || (open_errno = ERRNO (), ERRFILE_NOT_FOUND (open_errno)))
     {
       int i;
@@ -197,7 +208,7 @@ touch (struct file *ft_file, const FT_CHANGE *ft_chg, bool date_set)
             ft_nowp[i] = NULL;
         }
 
-      if (! setft (ft_file, ft_nowp, ft_chg))
+      if (! setftctx (ft_file, ft_nowp, ft_chg, &ft_context))
         {
           set_errno = ERRNO ();
 
@@ -257,6 +268,224 @@ touch (struct file *ft_file, const FT_CHANGE *ft_chg, bool date_set)
   return true;
 }
 
+/* The size of buffer into which lines of the manifest are read at first.  */
+#define MANIFEST_BUFSIZE 65536
+
+/* Parse STR as the date and time in ISO 8601 format with UTC offset,
+   or the date string accepted by -d, and set its file time into *FT.
+   Return true if successful.  */
+
+static bool
+manifest_time (FT *ft, char const *str)
+{
+  FT_PARSING ft_parsing;
+  FT now;
+  intmax_t seconds;
+  int nsec;
+  int set_num = iso8601sec (str, &seconds, &nsec);
+
+  /* Convert the usual timestamp directly without the time zone. */
+  if (set_num != 0)
+    return set_num > 0 && sec2ft (seconds, nsec, ft);
+
+  ft_parsing.change = (FT_CHANGE) { .datetime_unset = true, .modflag = 0 };
+  if (! parseft (&ft_parsing, str))
+    return false;
+  else if (ft_parsing.timespec_seen)
+    {
+      *ft = ft_parsing.timespec.ft;
+      return true;
+    }
+
+  return currentftctx (&now, &ft_context)
+         && calcftctx (ft, &now, &ft_parsing.change, &ft_context);
+}
+
+/* Update the times of a file by a line of the manifest, which is
+   "PATH<TAB>TIME[<TAB>ATIME]" split into LINE of PATH and TIME_STR of
+   the rest, or NULL if no tab. Return true if successful.  */
+
+static bool
+touch_line (char *line, char *time_str, unsigned long int line_num,
+            const FT_CHANGE *ft_chg, bool no_dereference)
+{
+  struct file ft_file;
+  char *atime_str = NULL;
+  char *invalid_str = NULL;
+  int i;
+
+  if (time_str)
+    {
+      atime_str = strchr (time_str, '\t');
+      if (atime_str)
+        *atime_str++ = '\0';
+    }
+
+  if (*line == '\0' || ! time_str)
+    {
+      error (0, 0, _("%s:%lu: missing file or time"), manifest, line_num);
+      return false;
+    }
+  else if (! manifest_time (newtime + FT_MTIME, time_str))
+    invalid_str = time_str;
+  else if (atime_str && ! manifest_time (newtime + FT_ATIME, atime_str))
+    invalid_str = atime_str;
+
+  if (invalid_str)
+    {
+      error (0, 0, _("%s:%lu: invalid date format '%s'"),
+             manifest, line_num, invalid_str);
+      return false;
+    }
+
+  /* Set the access and creation time to the same as the modification
+     time unless specified. */
+  for (i = 0; i < FT_SIZE; i++)
+    {
+      if (i != FT_MTIME && (i != FT_ATIME || ! atime_str))
+        newtime[i] = newtime[FT_MTIME];
+    }
+  for (i = 0; ft_chg && i < FT_SIZE; i++)
+    {
+      if (! calcftctx (newtime + i, newtime + i, ft_chg, &ft_context))
+        {
+          error (0, 0, _("%s:%lu: cannot modify new time"),
+                 manifest, line_num);
+          return false;
+        }
+    }
+
+#ifdef USE_TM_GLIBC
+  INIT_FILE (ft_file, line, no_dereference);
+#else
+  static WCHAR *wname = NULL;
+  static int wname_size = 0;
+  int size = MultiByteToWideChar (CP_UTF8, 0, line, -1, NULL, 0);
+
+  if (size <= 0)
+    {
+      error (0, 0, _("%s:%lu: invalid file name"), manifest, line_num);
+      return false;
+    }
+  else if (size > wname_size)
+    {
+      WCHAR *p = realloc (wname, sizeof (WCHAR) * size);
+      if (! p)
+        error (EXIT_FAILURE, ENOMEM, _("failed to read '%s'"), manifest);
+
+      wname = p;
+      wname_size = size;
+    }
+
+  MultiByteToWideChar (CP_UTF8, 0, line, -1, wname, size);
+  INIT_FILE (ft_file, wname, false);
+#endif
+
+  return touch (&ft_file, NULL, true);
+}
+
+/* Parameters of touch_manifest passed to touch_manifest_line  */
+struct manifest_arg
+{
+  unsigned long int line_num;
+  const FT_CHANGE *ft_chg;
+  bool no_dereference;
+  bool ok;
+};
+
+/* Update the times of a file by a line of the manifest at INDEX, which is
+   split into LINE and TIME_STR, with parameters in *ARG.  */
+
+static void
+touch_manifest_line (char *line, char *time_str, size_t index, void *arg)
+{
+  struct manifest_arg *manifest_arg = arg;
+
+  /* Skip an empty line. */
+  if (*line != '\0' || time_str)
+    manifest_arg->ok &= touch_line (line, time_str,
+                                    manifest_arg->line_num + index + 1,
+                                    manifest_arg->ft_chg,
+                                    manifest_arg->no_dereference);
+}
+
+/* Update the times of each file listed in the manifest, reading its
+   lines by the buffer extended for a long line.  Return true if all
+   files are updated successfully.  */
+
+static bool
+touch_manifest (const FT_CHANGE *ft_chg, bool no_dereference)
+{
+  FILE *stream;
+  size_t alloc = MANIFEST_BUFSIZE;
+  size_t size = 0;
+  char *buf = malloc (alloc);
+  struct manifest_arg manifest_arg = { 0, ft_chg, no_dereference, true };
+  bool eof = false;
+
+  if (! buf)
+    error (EXIT_FAILURE, ENOMEM, _("failed to read '%s'"), manifest);
+
+  if (strcmp (manifest, "-") == 0)
+#ifdef USE_TM_GLIBC
+    /* Read the manifest from the duplicate because standard input is
+       reopened for each file. */
+    stream = fdopen (dup (STDIN_FILENO), "r");
+#else
+    stream = stdin;
+#endif
+  else
+    stream = fopen (manifest, "rb");
+
+  if (! stream)
+    error (EXIT_FAILURE, ERRNO (), _("failed to open '%s'"), manifest);
+
+  while (! eof)
+    {
+      size_t read_size = fread (buf + size, 1, alloc - size - 1, stream);
+      char *p;
+
+      if (read_size == 0)
+        {
+          if (ferror (stream))
+            error (EXIT_FAILURE, ERRNO (), _("failed to read '%s'"),
+                   manifest);
+
+          /* Update the last line not terminated by a newline. */
+          eof = true;
+          if (size == 0)
+            break;
+          buf[size++] = '\n';
+        }
+      else
+        size += read_size;
+
+      manifest_arg.line_num += splitlines (buf, size, "\t", SIZE_MAX,
+                                           touch_manifest_line,
+                                           &manifest_arg, &p);
+
+      /* Move the line not terminated to the head of buffer, and extend
+         the buffer if filled by it. */
+      size -= p - buf;
+      memmove (buf, p, size);
+
+      if (size + 1 >= alloc)
+        {
+          alloc *= 2;
+          p = realloc (buf, alloc);
+          if (! p)
+            error (EXIT_FAILURE, ENOMEM, _("failed to read '%s'"), manifest);
+          buf = p;
+        }
+    }
+
+  if (stream != stdin)
+    fclose (stream);
+  free (buf);
+
+  return manifest_arg.ok;
+}
+
 static void
 usage (int status)
 {
@@ -294,6 +523,11 @@ Mandatory arguments to long options are mandatory for short options too.\n\
   -a                     change only the access time\n\
   -A, --use-atime        use the access time instead of current time\n\
 "), stdout);
+# if FT_SIZE > FT_BTIME
+      fputs (_("\
+  -B, --use-btime        use the birth time instead of current time\n\
+"), stdout);
+# endif
 #else
       fputs (_("\
   -a                     change only the last access time\n\
@@ -323,6 +557,10 @@ Mandatory arguments to long options are mandatory for short options too.\n\
 "), stdout);
 #endif
       fputs (_("\
+      --manifest=FILE    change times of each file listed in FILE by lines\n\
+                         of PATH<TAB>TIME[<TAB>ATIME], where TIME is in\n\
+                         ISO 8601 format or -d's; If FILE is -, read\n\
+                         standard input\n\
       --ns-permute       permute digits in nanoseconds at random\n\
       --ns-random=SEED   set the random value into nanoseconds by SEED;\n\
                          If 0, randomize by current time\n\
@@ -436,6 +674,10 @@ main (int argc, char **argv)
     error (EXIT_FAILURE, ERRNO (), _("failed to get command arguments"));
 #endif
 
+  /* Capture current time at once so that the time set for all files or
+     lines of the manifest is based on the same time. */
+  selectftclock (&ft_context, FT_CLOCK_FROZEN);
+
   ft_parsing.change = (FT_CHANGE) { .datetime_unset = true, .modflag = 0 };
   change_times = 0;
   change_used_time = -1;
@@ -458,7 +700,8 @@ main (int argc, char **argv)
         case 'b':
           change_times |= CH_BTIME;
           break;
-
+#endif
+#if FT_SIZE > FT_BTIME
         case 'B':
           change_used_time = FT_BTIME;
           used_times |= CH_BTIME;
@@ -500,6 +743,10 @@ main (int argc, char **argv)
           used_times |= CH_MTIME;
           break;
 
+        case MANIFEST_OPTION:	/* --manifest */
+          manifest = optarg;
+          break;
+
         case NS_PERMUTE_OPTION:	/* --ns-permute */
           ft_chgp = &ft_parsing.change;
           ft_chgp->modflag |= FT_NSEC_PERMUTE;
@@ -539,7 +786,8 @@ main (int argc, char **argv)
           {
             intmax_t seconds;
             if (! posixtime (&seconds, optarg,
-                             PDS_LEADING_YEAR | PDS_CENTURY | PDS_SECONDS)
+                             PDS_LEADING_YEAR | PDS_CENTURY | PDS_SECONDS,
+                             NULL)
                 || ! sec2ft (seconds, 0, &newtime[0]))
               error (EXIT_FAILURE, 0, _("invalid date format '%s'"), optarg);
             for (i = 1; i < FT_SIZE; i++)
@@ -550,7 +798,7 @@ main (int argc, char **argv)
 
 #ifdef USE_TM_SELFIMPL
         case TRANS_NODST_OPTION:	/* --trans-nodst */
-          trans_isdst = 0;
+          ft_context.trans_isdst = 0;
           break;
 #endif
 
@@ -583,8 +831,10 @@ main (int argc, char **argv)
     change_times = CH_ATIME | CH_MTIME | CH_BTIME;
 
   if ((date_set && (use_ref || use_each || used_times || flex_date))
+      || (manifest && (date_set || use_ref || use_each || used_times
+                       || flex_date))
       || (use_ref && use_each)
-      || used_times >= (CH_ATIME | CH_MTIME))
+      || (used_times & (used_times - 1)) != 0)
     {
       error (0, 0, _("cannot specify times from more than one source"));
       usage (EXIT_FAILURE);
@@ -599,13 +849,37 @@ main (int argc, char **argv)
         }
       else if (IS_FT_NSEC_RANDOMIZING (ft_chgp->modflag))
         /* Generate a new sequence at once before get random values. */
-        srandsec (--seed);
+        srandsecr (&ft_context.rand, --seed);
+    }
+
+  /* Change times of files listed in the manifest instead of operands. */
+  if (manifest)
+    {
+      if (optind < argc)
+        {
+          error (0, 0, _("extra operand '%s'"), argv[optind]);
+          usage (EXIT_FAILURE);
+        }
+
+#ifdef USE_TM_GLIBC
+      ok = touch_manifest (ft_chgp, no_dereference);
+#else
+      ok = touch_manifest (ft_chgp, false);
+      LocalFree (wargv);
+#endif
+
+      return (ok ? EXIT_SUCCESS : EXIT_FAILURE);
     }
 
   /* Use each file's time if specify -A, -B, or -M without -r option. */
   if (!use_ref && change_used_time >= 0)
     use_each = true;
 
+  /* Fail to get file times if the creation time is used but not supported
+     by a file. */
+  if (used_times & CH_BTIME)
+    used_mask |= FT_BTIME_MASK;
+
   /* Set the same new time for all files except the case that the access,
      modification, and/or creation time of each file is used. */
   if (use_ref || (!use_each && !date_set))
@@ -616,7 +890,7 @@ main (int argc, char **argv)
 
       if (use_ref)
         {
-          if (! getft (newtime, &ref_file))
+          if (! getftmask (newtime, &ref_file, used_mask))
             errfile (EXIT_FAILURE, ERRNO (),
                      _("failed to get attributes of"), &ref_file);
           else if (change_used_time < 0)
@@ -633,7 +907,7 @@ main (int argc, char **argv)
             newtime[date_set_index].tv_nsec = UTIME_NOW;
           else
 #endif
-          if (! currentft (newtime + date_set_index))
+          if (! currentftctx (newtime + date_set_index, &ft_context))
             error (EXIT_FAILURE, 0, _("failed to get system clock"));
         }
 
@@ -644,7 +918,8 @@ main (int argc, char **argv)
         {
           if (i > date_set_index)
             newtime[i % FT_SIZE] = newtime[date_set_index];
-          else if (ft_chgp && ! calcft (newtime + i, newtime + i, ft_chgp))
+          else if (ft_chgp && ! calcftctx (newtime + i, newtime + i,
+                                           ft_chgp, &ft_context))
             {
               if (flex_date)
                 error (EXIT_FAILURE, 0,
@@ -661,7 +936,7 @@ main (int argc, char **argv)
   else if (date_set && ft_chgp)
     {
       /* Change current time by modification options. */
-      if (! calcft (newtime, newtime, ft_chgp))
+      if (! calcftctx (newtime, newtime, ft_chgp, &ft_context))
         error (EXIT_FAILURE, 0, _("cannot modify current time"));
 
       for (i = 1; i < FT_SIZE; i++)